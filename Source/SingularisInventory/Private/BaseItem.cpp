@@ -10,3 +10,13 @@
 
 #include "BaseItem.h"
 
+void UBaseItem::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// 估算模式下父类已经通过序列化计数，这里只补充独占模式的实例大小
+	if (CumulativeResourceSize.GetResourceSizeMode() == EResourceSizeMode::Exclusive)
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(
+			GetClass()->GetStructureSize() + DisplayName.ToString().GetAllocatedSize()
+		);
+}
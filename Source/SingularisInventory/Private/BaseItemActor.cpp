@@ -10,21 +10,62 @@
 
 #include "BaseItemActor.h"
 
+#include "ItemDropSubsystem.h"
+#include "ItemSpatialSubsystem.h"
+#include "Net/UnrealNetwork.h"
+
 ABaseItemActor::ABaseItemActor()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
 }
 
+void ABaseItemActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// 掉落标识只在生成时确定，随初始复制到达即可
+	DOREPLIFETIME_CONDITION(ABaseItemActor, DropKey, COND_InitialOnly);
+}
+
 void ABaseItemActor::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if (UItemSpatialSubsystem* SpatialSubsystem = GetWorld()->GetSubsystem<UItemSpatialSubsystem>())
+	{
+		SpatialHandle = SpatialSubsystem->RegisterItemActor(this);
+		LastSpatialLocation = GetActorLocation();
+	}
+
+	// 服务器提升的掉落复制到达后，替换客户端本地仍在渲染的实例
+	if (!HasAuthority() && GetIsReplicated())
+		if (UItemDropSubsystem* DropSubsystem = GetWorld()->GetSubsystem<UItemDropSubsystem>())
+			DropSubsystem->ReleaseReplicatedDrop(this);
+}
+
+void ABaseItemActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (SpatialHandle != INDEX_NONE)
+		if (UItemSpatialSubsystem* SpatialSubsystem = GetWorld()->GetSubsystem<UItemSpatialSubsystem>())
+			SpatialSubsystem->UnregisterItemActor(SpatialHandle);
+	SpatialHandle = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ABaseItemActor::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	// 静态物品不会移动，无需同步；移动不足 1 厘米时同样忽略
+	if (SpatialHandle == INDEX_NONE || IsRootComponentStatic()) return;
+
+	const FVector Location = GetActorLocation();
+	if (FVector::DistSquared(Location, LastSpatialLocation) < 1.0f) return;
+
+	if (UItemSpatialSubsystem* SpatialSubsystem = GetWorld()->GetSubsystem<UItemSpatialSubsystem>())
+		SpatialSubsystem->UpdateItemActor(SpatialHandle, Location);
+	LastSpatialLocation = Location;
 }
 
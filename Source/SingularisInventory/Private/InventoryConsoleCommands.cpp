@@ -0,0 +1,220 @@
+/* =====================================================================
+ * InventoryConsoleCommands.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+#include "BaseItem.h"
+#include "InventoryLootTable.h"
+#include "InventoryManager.h"
+#include "InventoryMemory.h"
+#include "InventoryStressTest.h"
+
+namespace
+{
+	void DumpMemoryReport(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		SingularisInventory::TScratchMap<const UClass*, int64> BytesPerClass;
+		SingularisInventory::TScratchSet<const UObject*> CountedIcons;
+		FInventoryMemoryUsage Total;
+		int32 NumManagers = 0;
+
+		for (TObjectIterator<UInventoryManager> It; It; ++It)
+		{
+			const UInventoryManager* Manager = *It;
+			if (Manager->IsTemplate() || (World && Manager->GetWorld() != World)) continue;
+
+			const FInventoryMemoryUsage Usage = Manager->CollectMemoryUsage(BytesPerClass, CountedIcons);
+			Ar.Logf(
+				TEXT("  %s: 槽位 %d, 管理器 %lld, 物品 %lld, 图标 %lld, 控件 %lld, 合计 %lld 字节%s"),
+				*Manager->GetFullName(),
+				Manager->Slots.Num(),
+				Usage.ManagerBytes,
+				Usage.ItemBytes,
+				Usage.IconBytes,
+				Usage.WidgetBytes,
+				Usage.GetTotalBytes(),
+				Manager->MemoryBudgetBytes > 0 ? *FString::Printf(TEXT("（预算 %lld）"), Manager->MemoryBudgetBytes) : TEXT("")
+			);
+
+			Total.ManagerBytes += Usage.ManagerBytes;
+			Total.ItemBytes += Usage.ItemBytes;
+			Total.IconBytes += Usage.IconBytes;
+			Total.WidgetBytes += Usage.WidgetBytes;
+			++NumManagers;
+		}
+
+		BytesPerClass.ValueSort([](const int64 A, const int64 B) { return A > B; });
+		Ar.Logf(TEXT("按物品类统计:"));
+		for (const TPair<const UClass*, int64>& Pair : BytesPerClass)
+			Ar.Logf(TEXT("  %s: %lld 字节"), *GetNameSafe(Pair.Key), Pair.Value);
+
+		Ar.Logf(
+			TEXT("库存管理器 %d 个, 管理器 %lld, 物品 %lld, 图标 %lld, 控件 %lld, 合计 %lld 字节; 临时缓冲溢出到堆累计 %llu 次"),
+			NumManagers,
+			Total.ManagerBytes,
+			Total.ItemBytes,
+			Total.IconBytes,
+			Total.WidgetBytes,
+			Total.GetTotalBytes(),
+			SingularisInventory::GetScratchSpillCount()
+		);
+	}
+
+	void RunStress(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		// 控制台默认规模较小，避免在线上服务器上造成长时间卡顿
+		FInventoryStressParams Params;
+		Params.NumInventories = 16;
+		Params.SlotsPerInventory = 100;
+		Params.NumOperations = 100000;
+		Params.GCInterval = 0;
+		Params.Parse(*FString::Join(Args, TEXT(" ")));
+
+		if (Params.bCompareStorage)
+		{
+			const TPair<FInventoryStressResult, FInventoryStressResult> Results = SingularisInventory::RunStorageComparison(Params);
+			Ar.Logf(TEXT("库存压力测试存储方式对比:\n%s"), *SingularisInventory::DescribeStorageComparison(Results));
+			return;
+		}
+
+		const FInventoryStressResult Result = SingularisInventory::RunStressTest(Params);
+		Ar.Logf(TEXT("库存压力测试结果: %s"), *Result.ToString());
+	}
+
+	void RunSpatialBench(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FItemSpatialBenchmarkParams Params;
+		Params.NumFrames = 60;
+		Params.Parse(*FString::Join(Args, TEXT(" ")));
+
+		const FItemSpatialBenchmarkResult Result = SingularisInventory::RunSpatialBenchmark(Params);
+		Ar.Logf(TEXT("世界物品空间查询基准结果: %s"), *Result.ToString());
+	}
+
+	void RunLootBench(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 NumDraws = 100000;
+		int32 NumEntries = 64;
+		int32 Seed = 0;
+		FParse::Value(*Params, TEXT("Draws="), NumDraws);
+		FParse::Value(*Params, TEXT("Entries="), NumEntries);
+		FParse::Value(*Params, TEXT("Seed="), Seed);
+		NumDraws = FMath::Max(NumDraws, 1);
+		NumEntries = FMath::Max(NumEntries, 1);
+
+		UInventoryLootTable* Table = NewObject<UInventoryLootTable>(GetTransientPackage());
+		FRandomStream Random(Seed);
+		double TotalWeight = 0.0;
+		for (int32 i = 0; i < NumEntries; ++i)
+		{
+			FInventoryLootEntry& Entry = Table->Entries.AddDefaulted_GetRef();
+			Entry.ItemID = i;
+			Entry.Weight = Random.FRandRange(0.1f, 10.0f);
+			TotalWeight += Entry.Weight;
+		}
+		Table->Compile();
+
+		// 对照实现：逐次生成随机数并线性遍历权重
+		const double LinearStart = FPlatformTime::Seconds();
+		int64 LinearChecksum = 0;
+		for (int32 Draw = 0; Draw < NumDraws; ++Draw)
+		{
+			double Roll = Random.GetFraction() * TotalWeight;
+			int32 Picked = NumEntries - 1;
+			for (int32 i = 0; i < NumEntries; ++i)
+			{
+				Roll -= Table->Entries[i].Weight;
+				if (Roll < 0.0)
+				{
+					Picked = i;
+					break;
+				}
+			}
+			LinearChecksum += Picked;
+		}
+		const double LinearSeconds = FPlatformTime::Seconds() - LinearStart;
+
+		const double AliasStart = FPlatformTime::Seconds();
+		TArray<TPair<int32, int32>> ItemCounts;
+		Table->SampleTotals(NumDraws, Seed, ItemCounts);
+		const double AliasSeconds = FPlatformTime::Seconds() - AliasStart;
+
+		Ar.Logf(
+			TEXT("掉落表抽取基准: 抽取 %d 次, 条目 %d, 线性遍历 %.3f 毫秒 (校验 %lld), 别名表并行 %.3f 毫秒, 产出 %d 种物品"),
+			NumDraws,
+			NumEntries,
+			LinearSeconds * 1000.0,
+			LinearChecksum,
+			AliasSeconds * 1000.0,
+			ItemCounts.Num()
+		);
+	}
+
+	void DumpInventories(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		// 可选参数：只输出名称中包含该字符串的库存管理器
+		const FString Filter = Args.Num() > 0 ? Args[0] : FString();
+
+		for (TObjectIterator<UInventoryManager> It; It; ++It)
+		{
+			const UInventoryManager* Manager = *It;
+			if (Manager->IsTemplate() || (World && Manager->GetWorld() != World)) continue;
+			if (!Filter.IsEmpty() && !Manager->GetFullName().Contains(Filter)) continue;
+
+			Ar.Logf(TEXT("%s: 槽位 %d, 选中 %d"), *Manager->GetFullName(), Manager->Slots.Num(), Manager->SlotSelect);
+			for (int32 i = 0; i < Manager->Slots.Num(); ++i)
+			{
+				const FInventorySlot& Slot = Manager->Slots[i];
+				const UBaseItem* Item = Slot.GetItem();
+				if (Slot.bIsEmpty) continue;
+				Ar.Logf(
+					TEXT("  [%d] ID %d %s (%s)%s"),
+					i,
+					Slot.ItemID,
+					Item ? *Item->DisplayName.ToString() : TEXT("<未注册>"),
+					Item ? *Item->GetClass()->GetName() : TEXT("-"),
+					Slot.Item ? TEXT("") : TEXT(" [紧凑]")
+				);
+			}
+		}
+	}
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice StressCommand(
+		TEXT("SI.Stress"),
+		TEXT("在当前进程中运行库存吞吐压力测试。参数: [Inventories=16] [Slots=100] [Ops=100000] [GCInterval=0] [Seed=0] [-Compact] [-Prefill] [-MeasureGC=N] [-CompareStorage]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&RunStress)
+	);
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice SpatialBenchmarkCommand(
+		TEXT("SI.SpatialBench"),
+		TEXT("运行世界物品空间查询基准。参数: [Items=10000] [Players=64] [Frames=60] [Churn=32] [Radius=300] [CellSize=500] [Seed=0]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&RunSpatialBench)
+	);
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice LootBenchmarkCommand(
+		TEXT("SI.LootBench"),
+		TEXT("对比掉落表别名表并行抽取与线性权重遍历的耗时。参数: [Draws=100000] [Entries=64] [Seed=0]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&RunLootBench)
+	);
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpCommand(
+		TEXT("SI.Dump"),
+		TEXT("输出当前世界中库存管理器的槽位内容。参数: [名称过滤]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&DumpInventories)
+	);
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice MemReportCommand(
+		TEXT("SI.MemReport"),
+		TEXT("输出当前世界中所有库存管理器的内存占用报告，按库存、物品类、图标与控件分类统计"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&DumpMemoryReport)
+	);
+}
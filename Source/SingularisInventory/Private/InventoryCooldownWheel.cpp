@@ -0,0 +1,70 @@
+/* =====================================================================
+ * InventoryCooldownWheel.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryCooldownWheel.h"
+
+FInventoryCooldownWheel::FInventoryCooldownWheel(const float InTickSeconds, const int32 InNumBuckets)
+	: TickSeconds(FMath::Max(InTickSeconds, UE_KINDA_SMALL_NUMBER))
+{
+	Buckets.SetNum(FMath::Max(InNumBuckets, 1));
+}
+
+void FInventoryCooldownWheel::Start(const int32 Key, const float Seconds)
+{
+	if (Seconds <= 0.0f)
+	{
+		Active.Remove(Key);
+		return;
+	}
+
+	// 下一个刻度只剩 TickSeconds - Accumulator，把已累积的部分计入时长再向上取整，保证冷却不会被刻度截短
+	const uint64 ExpireTick = CurrentTick + FMath::Max<uint64>(FMath::CeilToInt64((Accumulator + Seconds) / TickSeconds), 1);
+	Active.Add(Key, ExpireTick);
+	Buckets[ExpireTick % Buckets.Num()].Add(Key);
+}
+
+float FInventoryCooldownWheel::GetRemaining(const int32 Key) const
+{
+	const uint64* ExpireTick = Active.Find(Key);
+	if (!ExpireTick || *ExpireTick <= CurrentTick) return 0.0f;
+	return FMath::Max((*ExpireTick - CurrentTick) * TickSeconds - Accumulator, 0.0f);
+}
+
+void FInventoryCooldownWheel::Advance(const float DeltaTime)
+{
+	if (Active.IsEmpty())
+	{
+		// 没有冷却时不需要推进桶，只保持时间基准
+		Accumulator = 0.0f;
+		return;
+	}
+
+	Accumulator += DeltaTime;
+	while (Accumulator >= TickSeconds)
+	{
+		Accumulator -= TickSeconds;
+		++CurrentTick;
+
+		TArray<int32>& Bucket = Buckets[CurrentTick % Buckets.Num()];
+		for (int32 i = Bucket.Num() - 1; i >= 0; --i)
+		{
+			const int32 Key = Bucket[i];
+			const uint64* ExpireTick = Active.Find(Key);
+
+			// 旧条目（冷却已刷新或已移除）直接丢弃；超过一圈的冷却留在桶中等待下一圈
+			if (!ExpireTick || *ExpireTick % Buckets.Num() != CurrentTick % Buckets.Num())
+				Bucket.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			else if (*ExpireTick <= CurrentTick)
+			{
+				Active.Remove(Key);
+				Bucket.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			}
+		}
+	}
+}
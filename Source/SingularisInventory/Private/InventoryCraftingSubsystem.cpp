@@ -0,0 +1,316 @@
+/* =====================================================================
+ * InventoryCraftingSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryCraftingSubsystem.h"
+
+#include "BaseItem.h"
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+#include "InventoryMemory.h"
+#include "SingularisInventory.h"
+#include "Engine/Engine.h"
+
+UInventoryCraftingSubsystem* UInventoryCraftingSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UInventoryCraftingSubsystem>() : nullptr;
+}
+
+void UInventoryCraftingSubsystem::Deinitialize()
+{
+	for (TPair<TObjectKey<UInventoryManager>, FCraftingTracker>& Pair : Trackers)
+		if (UInventoryManager* Inventory = Pair.Value.Inventory.Get())
+			Inventory->OnSlotChangedNative.Remove(Pair.Value.SlotChangedHandle);
+	Trackers.Reset();
+
+	Super::Deinitialize();
+}
+
+#pragma region 配方索引
+
+void UInventoryCraftingSubsystem::RegisterRecipeBook(UInventoryRecipeBook* RecipeBook)
+{
+	if (!RecipeBook || RecipeBooks.Contains(RecipeBook)) return;
+
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	RecipeBooks.Add(RecipeBook);
+	Recipes.Reserve(Recipes.Num() + RecipeBook->Recipes.Num());
+
+	for (const FInventoryRecipe& Source : RecipeBook->Recipes)
+	{
+		if (Source.ResultItemID == INDEX_NONE) continue;
+
+		if (!Source.RecipeName.IsNone() && RecipesByName.Contains(Source.RecipeName))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("配方 %s 已注册，忽略 %s 中的同名配方"), *Source.RecipeName.ToString(), *RecipeBook->GetName());
+			continue;
+		}
+
+		// 合并同一材料的多个条目，保证每个配方在反向索引中每种材料只出现一次
+		FInventoryRecipe Compiled = Source;
+		Compiled.Ingredients.Reset();
+		for (const FInventoryRecipeIngredient& Ingredient : Source.Ingredients)
+		{
+			if (Ingredient.ItemID == INDEX_NONE || Ingredient.Quantity <= 0) continue;
+
+			FInventoryRecipeIngredient* Existing = Compiled.Ingredients.FindByPredicate(
+				[&Ingredient](const FInventoryRecipeIngredient& Other) { return Other.ItemID == Ingredient.ItemID; }
+			);
+			if (Existing)
+				Existing->Quantity += Ingredient.Quantity;
+			else
+				Compiled.Ingredients.Add(Ingredient);
+		}
+		Compiled.ResultQuantity = FMath::Max(Compiled.ResultQuantity, 1);
+
+		// 没有有效材料的配方会被视为始终可合成，等于免费产出物品
+		if (Compiled.Ingredients.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s 中的配方 %s 没有有效材料，已忽略"), *RecipeBook->GetName(), *Source.RecipeName.ToString());
+			continue;
+		}
+
+		const int32 RecipeIndex = Recipes.Add(MoveTemp(Compiled));
+		for (const FInventoryRecipeIngredient& Ingredient : Recipes[RecipeIndex].Ingredients)
+			IngredientIndex.FindOrAdd(Ingredient.ItemID).Add({RecipeIndex, Ingredient.Quantity});
+		if (!Recipes[RecipeIndex].RecipeName.IsNone())
+			RecipesByName.Add(Recipes[RecipeIndex].RecipeName, RecipeIndex);
+	}
+
+	// 配方数量变化后重新统计已跟踪的库存
+	for (TPair<TObjectKey<UInventoryManager>, FCraftingTracker>& Pair : Trackers)
+		RebuildTracker(Pair.Value);
+}
+
+FInventoryRecipe UInventoryCraftingSubsystem::GetRecipe(const int32 RecipeIndex) const
+{
+	return Recipes.IsValidIndex(RecipeIndex) ? Recipes[RecipeIndex] : FInventoryRecipe();
+}
+
+int32 UInventoryCraftingSubsystem::FindRecipe(const FName RecipeName) const
+{
+	const int32* RecipeIndex = RecipesByName.Find(RecipeName);
+	return RecipeIndex ? *RecipeIndex : INDEX_NONE;
+}
+
+void UInventoryCraftingSubsystem::GetRecipesUsingItem(const int32 ItemID, TArray<int32>& OutRecipeIndices) const
+{
+	OutRecipeIndices.Reset();
+	if (const TArray<FIngredientUse>* Uses = IngredientIndex.Find(ItemID))
+		for (const FIngredientUse& Use : *Uses)
+			OutRecipeIndices.Add(Use.RecipeIndex);
+}
+
+#pragma endregion
+
+#pragma region 库存跟踪
+
+void UInventoryCraftingSubsystem::TrackInventory(UInventoryManager* Inventory)
+{
+	FindOrAddTracker(Inventory);
+}
+
+void UInventoryCraftingSubsystem::UntrackInventory(UInventoryManager* Inventory)
+{
+	FCraftingTracker Tracker;
+	if (Inventory && Trackers.RemoveAndCopyValue(Inventory, Tracker))
+		Inventory->OnSlotChangedNative.Remove(Tracker.SlotChangedHandle);
+}
+
+UInventoryCraftingSubsystem::FCraftingTracker* UInventoryCraftingSubsystem::FindOrAddTracker(UInventoryManager* Inventory)
+{
+	if (!Inventory) return nullptr;
+
+	if (FCraftingTracker* Existing = Trackers.Find(Inventory))
+		return Existing;
+
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	// 顺带清理已销毁库存留下的跟踪状态
+	for (auto It = Trackers.CreateIterator(); It; ++It)
+		if (!It.Value().Inventory.IsValid())
+			It.RemoveCurrent();
+
+	FCraftingTracker& Tracker = Trackers.Add(Inventory);
+	Tracker.Inventory = Inventory;
+	Tracker.SlotChangedHandle = Inventory->OnSlotChangedNative.AddUObject(this, &UInventoryCraftingSubsystem::HandleSlotChanged);
+	RebuildTracker(Tracker);
+	return &Tracker;
+}
+
+void UInventoryCraftingSubsystem::RebuildTracker(FCraftingTracker& Tracker) const
+{
+	const UInventoryManager* Inventory = Tracker.Inventory.Get();
+	const int32 NumSlots = Inventory ? Inventory->Slots.Num() : 0;
+
+	Tracker.SlotItemIDs.Init(INDEX_NONE, NumSlots);
+	Tracker.SlotQuantities.Init(0, NumSlots);
+	Tracker.ItemCounts.Reset();
+	for (int32 i = 0; i < NumSlots; ++i)
+	{
+		const FInventorySlot& Slot = Inventory->Slots[i];
+		if (Slot.bIsEmpty || Slot.ItemID == INDEX_NONE) continue;
+
+		Tracker.SlotItemIDs[i] = Slot.ItemID;
+		Tracker.SlotQuantities[i] = Slot.Quantity;
+		Tracker.ItemCounts.FindOrAdd(Slot.ItemID) += Slot.Quantity;
+	}
+
+	Tracker.SatisfiedIngredients.Init(0, Recipes.Num());
+	Tracker.Craftable.Init(false, Recipes.Num());
+	for (int32 RecipeIndex = 0; RecipeIndex < Recipes.Num(); ++RecipeIndex)
+	{
+		int32 Satisfied = 0;
+		for (const FInventoryRecipeIngredient& Ingredient : Recipes[RecipeIndex].Ingredients)
+		{
+			const int32* Count = Tracker.ItemCounts.Find(Ingredient.ItemID);
+			if (Count && *Count >= Ingredient.Quantity)
+				++Satisfied;
+		}
+		Tracker.SatisfiedIngredients[RecipeIndex] = Satisfied;
+		Tracker.Craftable[RecipeIndex] = Satisfied == Recipes[RecipeIndex].Ingredients.Num();
+	}
+}
+
+void UInventoryCraftingSubsystem::HandleSlotChanged(UInventoryManager* Inventory, const int32 SlotIndex)
+{
+	FCraftingTracker* Tracker = Trackers.Find(Inventory);
+	if (!Tracker || !Inventory->Slots.IsValidIndex(SlotIndex)) return;
+
+	// 槽位数组在运行时被扩展时补齐记录
+	if (!Tracker->SlotItemIDs.IsValidIndex(SlotIndex))
+	{
+		const int32 OldNum = Tracker->SlotItemIDs.Num();
+		Tracker->SlotItemIDs.SetNum(Inventory->Slots.Num());
+		Tracker->SlotQuantities.SetNumZeroed(Inventory->Slots.Num());
+		for (int32 i = OldNum; i < Tracker->SlotItemIDs.Num(); ++i)
+			Tracker->SlotItemIDs[i] = INDEX_NONE;
+	}
+
+	const FInventorySlot& Slot = Inventory->Slots[SlotIndex];
+	const int32 NewItemID = Slot.bIsEmpty ? INDEX_NONE : Slot.ItemID;
+	const int32 NewQuantity = NewItemID == INDEX_NONE ? 0 : Slot.Quantity;
+
+	const int32 OldItemID = Tracker->SlotItemIDs[SlotIndex];
+	const int32 OldQuantity = Tracker->SlotQuantities[SlotIndex];
+	Tracker->SlotItemIDs[SlotIndex] = NewItemID;
+	Tracker->SlotQuantities[SlotIndex] = NewQuantity;
+
+	if (OldItemID == NewItemID)
+	{
+		ApplyItemDelta(*Tracker, NewItemID, NewQuantity - OldQuantity);
+		return;
+	}
+	ApplyItemDelta(*Tracker, OldItemID, -OldQuantity);
+	ApplyItemDelta(*Tracker, NewItemID, NewQuantity);
+}
+
+void UInventoryCraftingSubsystem::ApplyItemDelta(FCraftingTracker& Tracker, const int32 ItemID, const int32 Delta) const
+{
+	if (ItemID == INDEX_NONE || Delta == 0) return;
+
+	int32& Count = Tracker.ItemCounts.FindOrAdd(ItemID);
+	const int32 OldCount = Count;
+	Count += Delta;
+	const int32 NewCount = Count;
+	if (NewCount <= 0)
+		Tracker.ItemCounts.Remove(ItemID);
+
+	const TArray<FIngredientUse>* Uses = IngredientIndex.Find(ItemID);
+	if (!Uses) return;
+
+	// 只有跨过材料需求数量时，配方的满足条目数才会变化
+	for (const FIngredientUse& Use : *Uses)
+	{
+		const bool bWasSatisfied = OldCount >= Use.Quantity;
+		const bool bIsSatisfied = NewCount >= Use.Quantity;
+		if (bWasSatisfied == bIsSatisfied) continue;
+
+		int32& Satisfied = Tracker.SatisfiedIngredients[Use.RecipeIndex];
+		Satisfied += bIsSatisfied ? 1 : -1;
+		Tracker.Craftable[Use.RecipeIndex] = Satisfied == Recipes[Use.RecipeIndex].Ingredients.Num();
+	}
+}
+
+#pragma endregion
+
+#pragma region 合成查询与执行
+
+void UInventoryCraftingSubsystem::GetCraftableRecipes(UInventoryManager* Inventory, TArray<int32>& OutRecipeIndices)
+{
+	OutRecipeIndices.Reset();
+
+	const FCraftingTracker* Tracker = FindOrAddTracker(Inventory);
+	if (!Tracker) return;
+
+	for (TConstSetBitIterator<> It(Tracker->Craftable); It; ++It)
+		OutRecipeIndices.Add(It.GetIndex());
+}
+
+bool UInventoryCraftingSubsystem::IsRecipeCraftable(UInventoryManager* Inventory, const int32 RecipeIndex)
+{
+	const FCraftingTracker* Tracker = FindOrAddTracker(Inventory);
+	return Tracker && Tracker->Craftable.IsValidIndex(RecipeIndex) && Tracker->Craftable[RecipeIndex];
+}
+
+int32 UInventoryCraftingSubsystem::GetItemCount(UInventoryManager* Inventory, const int32 ItemID)
+{
+	const FCraftingTracker* Tracker = FindOrAddTracker(Inventory);
+	const int32* Count = Tracker ? Tracker->ItemCounts.Find(ItemID) : nullptr;
+	return Count ? *Count : 0;
+}
+
+bool UInventoryCraftingSubsystem::Craft(UInventoryManager* Inventory, const int32 RecipeIndex)
+{
+	if (!IsRecipeCraftable(Inventory, RecipeIndex)) return false;
+
+	const FInventoryRecipe& Recipe = Recipes[RecipeIndex];
+	const UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	const UBaseItem* ResultDefinition = Registry ? Registry->FindItemDefinition(Recipe.ResultItemID) : nullptr;
+	if (!ResultDefinition) return false;
+
+	// 先规划每个槽位要扣除的数量 (槽位索引, 数量)，再确认产物放得下，保证失败时库存不变
+	SingularisInventory::TScratchArray<TPair<int32, int32>, 8> Removals;
+	SingularisInventory::TScratchBitArray<> FreedSlots(false, Inventory->Slots.Num());
+
+	for (const FInventoryRecipeIngredient& Ingredient : Recipe.Ingredients)
+	{
+		int32 Remaining = Ingredient.Quantity;
+		for (int32 i = 0; i < Inventory->Slots.Num() && Remaining > 0; ++i)
+		{
+			const FInventorySlot& Slot = Inventory->Slots[i];
+			if (Slot.bIsEmpty || Slot.ItemID != Ingredient.ItemID) continue;
+
+			const int32 Count = FMath::Min(Remaining, Slot.Quantity);
+			Removals.Add({i, Count});
+			FreedSlots[i] = Count == Slot.Quantity;
+			Remaining -= Count;
+		}
+		if (Remaining > 0) return false;
+	}
+
+	const int32 MaxStackSize = FMath::Max(ResultDefinition->MaxStackSize, 1);
+	int32 Capacity = 0;
+	for (int32 i = 0; i < Inventory->Slots.Num() && Capacity < Recipe.ResultQuantity; ++i)
+	{
+		const FInventorySlot& Slot = Inventory->Slots[i];
+		if (Slot.bIsEmpty || FreedSlots[i])
+			Capacity += MaxStackSize;
+		else if (Slot.ItemID == Recipe.ResultItemID && !Slot.Item && Slot.Attributes.IsEmpty())
+			Capacity += FMath::Max(MaxStackSize - Slot.Quantity, 0);
+	}
+	if (Capacity < Recipe.ResultQuantity) return false;
+
+	// 材料与产物各自批量写入，每个受影响的槽位在每一步中只刷新和广播一次
+	Inventory->RemoveItemCountBatch(Removals);
+	Inventory->TryAddItemsByID(Recipe.ResultItemID, Recipe.ResultQuantity);
+	return true;
+}
+
+#pragma endregion
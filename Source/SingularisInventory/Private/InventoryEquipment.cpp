@@ -0,0 +1,134 @@
+/* =====================================================================
+ * InventoryEquipment.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryEquipment.h"
+
+#include "BaseItem.h"
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+
+UInventoryEquipment::UInventoryEquipment()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UInventoryEquipment::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Inventory = GetOwner() ? GetOwner()->FindComponentByClass<UInventoryManager>() : nullptr;
+	if (!Inventory)
+		UE_LOG(LogTemp, Warning, TEXT("[%s] 所在 Actor 上没有库存管理器，无法佩戴物品"), *GetFullName());
+
+	// BeginPlay 之前已放入槽位的装备同样计入属性缓存
+	StatTotals.Reset();
+	for (const FInventoryEquipmentSlot& Slot : EquipmentSlots)
+		ApplyModifiers(Slot.Item, 1.0f);
+}
+
+bool UInventoryEquipment::Equip(const int32 InventorySlotIndex, int32 EquipmentSlotIndex)
+{
+	if (!Inventory) return false;
+
+	UBaseItem* Item = Inventory->GetItemInSlot(InventorySlotIndex);
+	if (!Item || !Item->bAccessory) return false;
+
+	if (EquipmentSlotIndex == INDEX_NONE)
+		EquipmentSlotIndex = FindEquipmentSlotFor(Item);
+	if (!EquipmentSlots.IsValidIndex(EquipmentSlotIndex) || EquipmentSlots[EquipmentSlotIndex].SlotType != Item->EquipmentSlotType)
+		return false;
+
+	// 取出前复制原槽位：实例属性随物品离开库存，放回原有装备失败时用它原样恢复
+	const FInventorySlot SourceSlot = Inventory->Slots[InventorySlotIndex];
+
+	// 先从库存取出一个，再把原有装备放回，保证原有装备有位置可放
+	if (!Inventory->RemoveItemCount(InventorySlotIndex, 1)) return false;
+
+	FInventoryEquipmentSlot& Slot = EquipmentSlots[EquipmentSlotIndex];
+	if (UBaseItem* Previous = Slot.Item)
+	{
+		if (!ReturnToInventory(Previous, Slot.Attributes))
+		{
+			// 库存已满或超出预算：取出之后库存没有其他变化，把原槽位恢复原状，物品回到原来的位置
+			Inventory->RestoreSlot(InventorySlotIndex, SourceSlot);
+			return false;
+		}
+		ApplyModifiers(Previous, -1.0f);
+	}
+
+	Slot.Item = Item;
+	Slot.Attributes = SourceSlot.Attributes;
+	ApplyModifiers(Item, 1.0f);
+	OnEquipmentChanged.Broadcast(EquipmentSlotIndex);
+	return true;
+}
+
+bool UInventoryEquipment::Unequip(const int32 EquipmentSlotIndex)
+{
+	if (!Inventory || !EquipmentSlots.IsValidIndex(EquipmentSlotIndex)) return false;
+
+	FInventoryEquipmentSlot& Slot = EquipmentSlots[EquipmentSlotIndex];
+	if (!Slot.Item || !ReturnToInventory(Slot.Item, Slot.Attributes)) return false;
+
+	ApplyModifiers(Slot.Item, -1.0f);
+	Slot.Item = nullptr;
+	Slot.Attributes.Reset();
+	OnEquipmentChanged.Broadcast(EquipmentSlotIndex);
+	return true;
+}
+
+FEquipmentStatTotal UInventoryEquipment::GetStatTotal(const FName StatName) const
+{
+	const FEquipmentStatTotal* Total = StatTotals.Find(StatName);
+	return Total ? *Total : FEquipmentStatTotal();
+}
+
+float UInventoryEquipment::ApplyStat(const FName StatName, const float BaseValue) const
+{
+	const FEquipmentStatTotal* Total = StatTotals.Find(StatName);
+	return Total ? (BaseValue + Total->Additive) * (1.0f + Total->Multiplier) : BaseValue;
+}
+
+void UInventoryEquipment::ApplyModifiers(const UBaseItem* Item, const float Sign)
+{
+	if (!Item) return;
+
+	for (const FItemStatModifier& Modifier : Item->StatModifiers)
+	{
+		if (Modifier.StatName.IsNone()) continue;
+
+		FEquipmentStatTotal& Total = StatTotals.FindOrAdd(Modifier.StatName);
+		Total.Additive += Sign * Modifier.Additive;
+		Total.Multiplier += Sign * Modifier.Multiplier;
+		Total.Contributors += Sign > 0.0f ? 1 : -1;
+
+		if (Total.Contributors <= 0)
+			StatTotals.Remove(Modifier.StatName);
+	}
+}
+
+int32 UInventoryEquipment::FindEquipmentSlotFor(const UBaseItem* Item) const
+{
+	int32 Fallback = INDEX_NONE;
+	for (int32 i = 0; i < EquipmentSlots.Num(); ++i)
+	{
+		if (EquipmentSlots[i].SlotType != Item->EquipmentSlotType) continue;
+		if (!EquipmentSlots[i].Item) return i;
+		if (Fallback == INDEX_NONE) Fallback = i;
+	}
+	return Fallback;
+}
+
+bool UInventoryEquipment::ReturnToInventory(UBaseItem* Item, const FInventoryItemAttributes& Attributes) const
+{
+	const UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	if (Registry && Registry->FindItemDefinition(Item->ItemID) == Item)
+		return Inventory->TryAddItemWithAttributes(Item->ItemID, Attributes);
+	return Inventory->TryAddItemInstance(Item, Attributes);
+}
@@ -0,0 +1,54 @@
+/* =====================================================================
+ * InventoryGridWidget.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryGridWidget.h"
+
+#include "InventoryManager.h"
+#include "SInventoryGrid.h"
+
+#define LOCTEXT_NAMESPACE "SingularisInventory"
+
+void UInventoryGridWidget::SetInventory(UInventoryManager* InInventory)
+{
+	Inventory = InInventory;
+	if (MyGrid.IsValid())
+		MyGrid->SetInventory(InInventory);
+}
+
+TSharedRef<SWidget> UInventoryGridWidget::RebuildWidget()
+{
+	MyGrid = SNew(SInventoryGrid)
+		.Inventory(Inventory)
+		.Columns(Columns)
+		.Style(Style);
+	return MyGrid.ToSharedRef();
+}
+
+void UInventoryGridWidget::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if (MyGrid.IsValid())
+		MyGrid->SetLayout(Columns, Style);
+}
+
+void UInventoryGridWidget::ReleaseSlateResources(const bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+	MyGrid.Reset();
+}
+
+#if WITH_EDITOR
+const FText UInventoryGridWidget::GetPaletteCategory()
+{
+	return LOCTEXT("InventoryPaletteCategory", "引力奇点库存系统");
+}
+#endif
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,98 @@
+/* =====================================================================
+ * InventoryItemAttributes.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryItemAttributes.h"
+
+const FInventoryItemAttributes FInventoryItemAttributes::Empty;
+
+int32 FInventoryItemAttributes::LowerBound(const FName Key) const
+{
+	// 条目很少，线性查找比二分更快
+	int32 Index = 0;
+	while (Index < Entries.Num() && Entries[Index].Key.FastLess(Key))
+		++Index;
+	return Index;
+}
+
+const int32* FInventoryItemAttributes::Find(const FName Key) const
+{
+	const int32 Index = LowerBound(Key);
+	return Entries.IsValidIndex(Index) && Entries[Index].Key == Key ? &Entries[Index].Value : nullptr;
+}
+
+void FInventoryItemAttributes::Set(const FName Key, const int32 Value)
+{
+	if (Key.IsNone()) return;
+
+	const int32 Index = LowerBound(Key);
+	if (Entries.IsValidIndex(Index) && Entries[Index].Key == Key)
+	{
+		if (Entries[Index].Value == Value) return;
+		Entries[Index].Value = Value;
+	}
+	else
+	{
+		Entries.Insert({Key, Value}, Index);
+	}
+	UpdateHash();
+}
+
+bool FInventoryItemAttributes::Remove(const FName Key)
+{
+	const int32 Index = LowerBound(Key);
+	if (!Entries.IsValidIndex(Index) || Entries[Index].Key != Key) return false;
+
+	Entries.RemoveAt(Index, 1, EAllowShrinking::No);
+	UpdateHash();
+	return true;
+}
+
+void FInventoryItemAttributes::Reset()
+{
+	Entries.Reset();
+	Hash = 0;
+}
+
+void FInventoryItemAttributes::UpdateHash()
+{
+	Hash = 0;
+	for (const FEntry& Entry : Entries)
+		Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(Entry.Key), GetTypeHash(Entry.Value)));
+}
+
+bool FInventoryItemAttributes::Serialize(FArchive& Ar)
+{
+	int32 NumEntries = Entries.Num();
+	Ar << NumEntries;
+
+	if (Ar.IsLoading())
+	{
+		// FName 的比较索引在不同进程之间不稳定，加载后重新排序
+		Entries.Reset();
+		for (int32 i = 0; i < NumEntries && !Ar.IsError(); ++i)
+		{
+			FName Key;
+			int32 Value = 0;
+			Ar << Key << Value;
+			Set(Key, Value);
+		}
+		UpdateHash();
+	}
+	else
+	{
+		for (FEntry& Entry : Entries)
+			Ar << Entry.Key << Entry.Value;
+	}
+	return true;
+}
+
+bool FInventoryItemAttributes::Identical(const FInventoryItemAttributes* Other, uint32 PortFlags) const
+{
+	return Other && *this == *Other;
+}
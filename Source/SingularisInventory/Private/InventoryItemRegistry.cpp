@@ -0,0 +1,81 @@
+/* =====================================================================
+ * InventoryItemRegistry.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryItemRegistry.h"
+
+#include "BaseItem.h"
+#include "Engine/Engine.h"
+
+UInventoryItemRegistry* UInventoryItemRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UInventoryItemRegistry>() : nullptr;
+}
+
+bool UInventoryItemRegistry::RegisterItemClass(const TSubclassOf<UBaseItem> ItemClass)
+{
+	if (!ItemClass || ItemClass->HasAnyClassFlags(CLASS_Abstract)) return false;
+
+	const int32 ItemID = ItemClass->GetDefaultObject<UBaseItem>()->ItemID;
+	if (const UBaseItem* Existing = FindItemDefinition(ItemID); Existing && Existing->GetClass() == ItemClass)
+		return true;
+
+	return RegisterItemDefinition(ItemID, CreateDefinition(ItemClass));
+}
+
+UBaseItem* UInventoryItemRegistry::CreateDefinition(const TSubclassOf<UBaseItem> ItemClass)
+{
+	// 不直接共享类默认对象：默认对象对整个进程可见，而且会被当作新实例的模板
+	return NewObject<UBaseItem>(this, ItemClass, NAME_None, RF_Transient);
+}
+
+bool UInventoryItemRegistry::RegisterItemDefinition(const int32 ItemID, UBaseItem* Definition)
+{
+	if (!Definition || ItemID == INDEX_NONE) return false;
+
+	if (Definition->HasAnyFlags(RF_ClassDefaultObject))
+	{
+		if (const UBaseItem* Existing = FindItemDefinition(ItemID); Existing && Existing->GetClass() == Definition->GetClass())
+			return true;
+		Definition = CreateDefinition(Definition->GetClass());
+		Definition->ItemID = ItemID;
+	}
+
+	UBaseItem*& Existing = Definitions.FindOrAdd(ItemID);
+	if (Existing && Existing != Definition && Existing->GetClass() != Definition->GetClass())
+	{
+		UE_LOG(
+			LogTemp,
+			Warning,
+			TEXT("物品ID %d 已被 %s 注册，忽略 %s 的注册"),
+			ItemID,
+			*Existing->GetClass()->GetName(),
+			*Definition->GetClass()->GetName()
+		);
+		return false;
+	}
+
+	if (!Existing)
+		Existing = Definition;
+	return true;
+}
+
+bool UInventoryItemRegistry::UnregisterItemDefinition(const int32 ItemID, const UBaseItem* ExpectedDefinition)
+{
+	const UBaseItem* const* Existing = Definitions.Find(ItemID);
+	if (!Existing || *Existing != ExpectedDefinition) return false;
+
+	Definitions.Remove(ItemID);
+	return true;
+}
+
+UBaseItem* UInventoryItemRegistry::FindItemDefinition(const int32 ItemID) const
+{
+	UBaseItem* const* Definition = Definitions.Find(ItemID);
+	return Definition ? *Definition : nullptr;
+}
@@ -0,0 +1,584 @@
+/* =====================================================================
+ * InventoryJournal.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryJournal.h"
+
+#include "SingularisInventory.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Memory/MemoryView.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/Class.h"
+
+static TAutoConsoleVariable<int32> CVarInventoryJournalFlushInterval(
+	TEXT("SI.JournalFlushInterval"),
+	50,
+	TEXT("库存操作日志后台线程批量写入文件的间隔（毫秒）"),
+	ECVF_Default
+);
+
+namespace
+{
+	constexpr uint32 SnapshotMagic = 0x53494E56; // "SINV"
+	constexpr uint32 SnapshotVersion = 3;
+
+	/** 版本 2 的快照不含实例属性，仍然可以读取 */
+	constexpr uint32 MinSnapshotVersion = 2;
+
+	/** 单条记录的负载上限，超过即视为损坏 */
+	constexpr uint32 MaxRecordPayloadSize = 64 * 1024;
+
+	/** 记录头（负载长度）与记录尾（CRC）的字节数 */
+	constexpr int32 RecordFramingSize = sizeof(uint32) * 2;
+
+	/** 从日志文件解码出的一条记录 */
+	struct FDecodedRecord
+	{
+		uint64 Sequence = 0;
+		EInventoryJournalOp Op = EInventoryJournalOp::Set;
+		int32 SlotIndex = INDEX_NONE;
+		int32 OtherSlotIndex = INDEX_NONE;
+		int32 ItemID = INDEX_NONE;
+		int32 Quantity = 0;
+		FInventoryItemAttributes Attributes;
+		FString ClassPath;
+	};
+
+	bool DecodeRecord(const uint8* Payload, const uint32 PayloadSize, FDecodedRecord& OutRecord)
+	{
+		FMemoryReaderView Ar(MakeMemoryView(Payload, PayloadSize));
+		uint8 Op = 0;
+		Ar << OutRecord.Sequence << Op << OutRecord.SlotIndex << OutRecord.OtherSlotIndex << OutRecord.ItemID << OutRecord.Quantity;
+		if (Op > static_cast<uint8>(EInventoryJournalOp::DefineItem)) return false;
+
+		OutRecord.Op = static_cast<EInventoryJournalOp>(Op);
+		OutRecord.Attributes.Reset();
+		if (OutRecord.Op == EInventoryJournalOp::DefineItem)
+			Ar << OutRecord.ClassPath;
+		else if (OutRecord.Op == EInventoryJournalOp::Set && Ar.Tell() < Ar.TotalSize())
+			OutRecord.Attributes.Serialize(Ar); // 早期的 Set 记录没有实例属性
+		return !Ar.IsError();
+	}
+}
+
+/**
+ * 共享的日志写入线程
+ *
+ * 只持有日志的弱引用，按 SI.JournalFlushInterval 的间隔或快照提交时被唤醒，
+ * 依次写出每个仍然存活的日志，已经销毁的日志顺带移出列表。
+ * 正在关闭的日志由写入线程暂时持有强引用，写出剩余记录后释放。
+ */
+class FInventoryJournalWriter final : public FRunnable
+{
+public:
+	FInventoryJournalWriter()
+	{
+		WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		Thread = FRunnableThread::Create(this, TEXT("InventoryJournalWriter"), 0, TPri_BelowNormal);
+	}
+
+	virtual ~FInventoryJournalWriter() override
+	{
+		if (Thread)
+		{
+			// Stop 唤醒线程，线程退出前会写出所有日志的剩余记录
+			Thread->Kill(true);
+			delete Thread;
+			Thread = nullptr;
+		}
+		else
+		{
+			FlushAll();
+		}
+
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+
+	void Register(const TSharedRef<FInventoryJournal, ESPMode::ThreadSafe>& Journal)
+	{
+		FScopeLock Lock(&JournalsLock);
+		Journals.Add(Journal);
+	}
+
+	void Wake() const
+	{
+		WakeEvent->Trigger();
+	}
+
+	/** 接管正在关闭的日志，写出剩余记录之前保持其存活 */
+	void Retire(TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>&& Journal)
+	{
+		{
+			FScopeLock Lock(&JournalsLock);
+			Closing.Add(MoveTemp(Journal));
+		}
+		WakeEvent->Trigger();
+	}
+
+	/** 在调用线程写出所有正在关闭的日志，重放之前调用，保证读到完整的文件 */
+	void FlushClosing()
+	{
+		TArray<TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>, TInlineAllocator<4>> Pending;
+		{
+			FScopeLock Lock(&JournalsLock);
+			Pending.Append(Closing);
+		}
+
+		// 写入线程可能正在写出同一个日志，FlushPending 通过 WriteLock 等待其完成
+		for (const TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>& Journal : Pending)
+			Journal->FlushPending();
+	}
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			WakeEvent->Wait(FMath::Max(CVarInventoryJournalFlushInterval.GetValueOnAnyThread(), 1));
+			FlushAll();
+		}
+
+		FlushAll();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WakeEvent->Trigger();
+	}
+	//~ End FRunnable Interface
+
+private:
+	void FlushAll()
+	{
+		TArray<TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>, TInlineAllocator<16>> Alive;
+		TArray<TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>, TInlineAllocator<4>> Retired;
+		{
+			FScopeLock Lock(&JournalsLock);
+			for (int32 i = Journals.Num() - 1; i >= 0; --i)
+			{
+				if (TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = Journals[i].Pin())
+					Alive.Add(MoveTemp(Journal));
+				else
+					Journals.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			}
+
+			// 正在关闭的日志同样在弱引用列表中，会随其他日志一起写出
+			Retired.Append(Closing);
+		}
+
+		// 写入期间不持有列表锁，游戏线程可以继续打开新的日志
+		for (const TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>& Journal : Alive)
+			Journal->FlushPending();
+
+		// 写出之后才移出关闭列表，重放前的 FlushClosing 不会错过尚未写出的日志
+		{
+			FScopeLock Lock(&JournalsLock);
+			for (const TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>& Journal : Retired)
+				Closing.RemoveSingleSwap(Journal, EAllowShrinking::No);
+		}
+	}
+
+	FCriticalSection JournalsLock;
+	TArray<TWeakPtr<FInventoryJournal, ESPMode::ThreadSafe>> Journals;
+	TArray<TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>> Closing;
+
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping = false;
+};
+
+namespace
+{
+	/** 所有日志共享的写入线程，只在持有 GWriterLock 时创建与销毁 */
+	FCriticalSection GWriterLock;
+	TUniquePtr<FInventoryJournalWriter> GWriter;
+}
+
+TSharedRef<FInventoryJournal, ESPMode::ThreadSafe> FInventoryJournal::Open(
+	const FString& Name,
+	const uint64 NextSequence,
+	TMap<int32, FString> ItemClasses
+)
+{
+	TSharedRef<FInventoryJournal, ESPMode::ThreadSafe> Journal = MakeShared<FInventoryJournal, ESPMode::ThreadSafe>(
+		Name,
+		NextSequence,
+		MoveTemp(ItemClasses)
+	);
+
+	FScopeLock Lock(&GWriterLock);
+	if (!GWriter)
+		GWriter = MakeUnique<FInventoryJournalWriter>();
+	GWriter->Register(Journal);
+	return Journal;
+}
+
+void FInventoryJournal::Close(TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>&& Journal)
+{
+	if (!Journal.IsValid()) return;
+
+	FScopeLock Lock(&GWriterLock);
+	if (GWriter)
+	{
+		GWriter->Retire(MoveTemp(Journal));
+		return;
+	}
+
+	// 写入线程已经停止（模块正在卸载），只能在调用线程写出
+	Journal->FlushPending();
+	Journal.Reset();
+}
+
+void FInventoryJournal::ShutdownWriter()
+{
+	TUniquePtr<FInventoryJournalWriter> Writer;
+	{
+		FScopeLock Lock(&GWriterLock);
+		Writer = MoveTemp(GWriter);
+	}
+	Writer.Reset();
+}
+
+FInventoryJournal::FInventoryJournal(const FString& Name, const uint64 InNextSequence, TMap<int32, FString> InItemClasses)
+	: JournalPath(GetJournalPath(Name))
+	, SnapshotPath(GetSnapshotPath(Name))
+	, NextSequence(FMath::Max<uint64>(InNextSequence, 1))
+	, ItemClasses(MoveTemp(InItemClasses))
+{
+	// Replay 已把日志截断到最后一条有效记录，这里追加的记录与之前的记录边界对齐
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*JournalPath, FILEWRITE_Append | FILEWRITE_AllowRead));
+	if (!Writer)
+		UE_LOG(LogTemp, Error, TEXT("无法打开库存操作日志 %s，操作将不会被持久化"), *JournalPath);
+}
+
+FInventoryJournal::~FInventoryJournal()
+{
+	// 最后一个引用可能在写入线程上释放，FlushPending 可以在任意线程执行
+	FlushPending();
+}
+
+FString FInventoryJournal::GetJournalPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InventoryJournal") / Name + TEXT(".journal");
+}
+
+FString FInventoryJournal::GetSnapshotPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InventoryJournal") / Name + TEXT(".snapshot");
+}
+
+#pragma region 记录
+
+void FInventoryJournal::RecordSet(
+	const int32 SlotIndex,
+	const int32 ItemID,
+	const int32 Quantity,
+	const FInventoryItemAttributes& Attributes,
+	const UClass* ItemClass
+)
+{
+	// 每个 ItemID 只需记录一次物品类路径，之后的记录与快照都能据此恢复
+	if (ItemClass && !ItemClasses.Contains(ItemID))
+	{
+		FString ClassPath = ItemClass->GetPathName();
+		Enqueue(EInventoryJournalOp::DefineItem, INDEX_NONE, INDEX_NONE, ItemID, 0, nullptr, &ClassPath);
+		ItemClasses.Add(ItemID, MoveTemp(ClassPath));
+	}
+
+	Enqueue(EInventoryJournalOp::Set, SlotIndex, INDEX_NONE, ItemID, Quantity, &Attributes);
+}
+
+void FInventoryJournal::RecordClear(const int32 SlotIndex)
+{
+	Enqueue(EInventoryJournalOp::Clear, SlotIndex, INDEX_NONE, INDEX_NONE, 0);
+}
+
+void FInventoryJournal::RecordSwap(const int32 FromIndex, const int32 ToIndex)
+{
+	Enqueue(EInventoryJournalOp::Swap, FromIndex, ToIndex, INDEX_NONE, 0);
+}
+
+void FInventoryJournal::Enqueue(
+	const EInventoryJournalOp Op,
+	int32 SlotIndex,
+	int32 OtherSlotIndex,
+	int32 ItemID,
+	int32 Quantity,
+	const FInventoryItemAttributes* Attributes,
+	FString* ClassPath
+)
+{
+	uint64 Sequence = NextSequence++;
+	uint8 OpValue = static_cast<uint8>(Op);
+
+	// 在游戏线程编码负载，复用同一个缓冲区
+	RecordBuffer.Reset();
+	FMemoryWriter Ar(RecordBuffer);
+	Ar << Sequence << OpValue << SlotIndex << OtherSlotIndex << ItemID << Quantity;
+	if (Attributes)
+		const_cast<FInventoryItemAttributes*>(Attributes)->Serialize(Ar); // 保存时不会修改属性
+	if (ClassPath)
+		Ar << *ClassPath;
+
+	const uint32 PayloadSize = RecordBuffer.Num();
+	const uint32 Checksum = FCrc::MemCrc32(RecordBuffer.GetData(), PayloadSize);
+
+	FScopeLock Lock(&PendingLock);
+	PendingBytes.Append(reinterpret_cast<const uint8*>(&PayloadSize), sizeof(uint32));
+	PendingBytes.Append(RecordBuffer);
+	PendingBytes.Append(reinterpret_cast<const uint8*>(&Checksum), sizeof(uint32));
+}
+
+void FInventoryJournal::WriteSnapshot(const TConstArrayView<FInventoryJournalSlotState> SlotStates)
+{
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	// 快照覆盖到目前为止分配的所有序号
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+	uint32 Magic = SnapshotMagic;
+	uint32 Version = SnapshotVersion;
+	uint64 SnapshotSequence = GetLastSequence();
+	int32 NumSlots = SlotStates.Num();
+	Ar << Magic << Version << SnapshotSequence << NumSlots;
+	for (FInventoryJournalSlotState State : SlotStates)
+		Ar << State;
+
+	// 新日志不会重复写出已有的类路径，快照必须带上完整的类表
+	Ar << ItemClasses;
+
+	uint32 Checksum = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+	Ar << Checksum;
+
+	{
+		FScopeLock Lock(&PendingLock);
+		PendingSnapshot = MoveTemp(Bytes);
+		PendingSnapshotOffset = PendingBytes.Num();
+	}
+
+	FScopeLock Lock(&GWriterLock);
+	if (GWriter)
+		GWriter->Wake();
+}
+
+#pragma endregion
+
+#pragma region 写入
+
+void FInventoryJournal::Flush()
+{
+	FlushPending();
+}
+
+void FInventoryJournal::FlushPending()
+{
+	FScopeLock WriteScope(&WriteLock);
+
+	TArray<uint8> Snapshot;
+	int32 SnapshotOffset = 0;
+	{
+		FScopeLock Lock(&PendingLock);
+		Swap(WritingBytes, PendingBytes);
+		Snapshot = MoveTemp(PendingSnapshot);
+		SnapshotOffset = PendingSnapshotOffset;
+		PendingSnapshotOffset = 0;
+	}
+
+	if (WritingBytes.Num() == 0 && Snapshot.Num() == 0) return;
+
+	// 快照之前的记录先写入旧日志，保证快照写失败时仍可从旧快照与完整日志恢复
+	const int32 SplitOffset = Snapshot.Num() > 0 ? SnapshotOffset : WritingBytes.Num();
+	if (Writer && SplitOffset > 0)
+	{
+		Writer->Serialize(WritingBytes.GetData(), SplitOffset);
+		Writer->Flush();
+	}
+
+	if (Snapshot.Num() > 0)
+	{
+		// 先写临时文件再替换，避免崩溃时留下不完整的快照
+		const FString TempPath = SnapshotPath + TEXT(".tmp");
+		bool bSnapshotWritten = false;
+		if (TUniquePtr<FArchive> SnapshotWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*TempPath)))
+		{
+			SnapshotWriter->Serialize(Snapshot.GetData(), Snapshot.Num());
+			bSnapshotWritten = SnapshotWriter->Close();
+		}
+		bSnapshotWritten = bSnapshotWritten && IFileManager::Get().Move(*SnapshotPath, *TempPath, true, true);
+
+		if (bSnapshotWritten)
+		{
+			// 快照已包含之前的全部记录，重新创建空日志
+			Writer.Reset();
+			Writer.Reset(IFileManager::Get().CreateFileWriter(*JournalPath, FILEWRITE_AllowRead));
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("写入库存快照 %s 失败，继续追加旧日志"), *SnapshotPath);
+		}
+	}
+
+	if (Writer && SplitOffset < WritingBytes.Num())
+	{
+		Writer->Serialize(WritingBytes.GetData() + SplitOffset, WritingBytes.Num() - SplitOffset);
+		Writer->Flush();
+	}
+
+	WritingBytes.Reset();
+}
+
+#pragma endregion
+
+#pragma region 重放
+
+uint64 FInventoryJournal::Replay(
+	const FString& Name,
+	TArray<FInventoryJournalSlotState>& InOutSlots,
+	TMap<int32, FString>& OutItemClasses
+)
+{
+	// 同名日志可能刚被关闭、剩余记录还在等待写入线程写出
+	{
+		FScopeLock Lock(&GWriterLock);
+		if (GWriter)
+			GWriter->FlushClosing();
+	}
+
+	uint64 LastSequence = 0;
+	OutItemClasses.Reset();
+
+	TArray<uint8> Bytes;
+	if (FFileHelper::LoadFileToArray(Bytes, *GetSnapshotPath(Name), FILEREAD_Silent) && Bytes.Num() > static_cast<int32>(sizeof(uint32)))
+	{
+		const int32 PayloadSize = Bytes.Num() - sizeof(uint32);
+		uint32 StoredChecksum = 0;
+		FMemory::Memcpy(&StoredChecksum, Bytes.GetData() + PayloadSize, sizeof(uint32));
+
+		FMemoryReader Ar(Bytes);
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		uint64 SnapshotSequence = 0;
+		int32 NumSlots = 0;
+		Ar << Magic << Version << SnapshotSequence << NumSlots;
+
+		bool bValid = Magic == SnapshotMagic
+			&& Version >= MinSnapshotVersion
+			&& Version <= SnapshotVersion
+			&& StoredChecksum == FCrc::MemCrc32(Bytes.GetData(), PayloadSize)
+			&& NumSlots >= 0
+			&& Ar.Tell() + NumSlots * static_cast<int64>(sizeof(int32) * 2) <= PayloadSize;
+
+		if (bValid)
+		{
+			TArray<FInventoryJournalSlotState> SnapshotSlots;
+			SnapshotSlots.SetNum(NumSlots);
+			for (FInventoryJournalSlotState& State : SnapshotSlots)
+			{
+				Ar << State.ItemID << State.Quantity;
+				if (Version >= 3)
+					State.Attributes.Serialize(Ar);
+			}
+			Ar << OutItemClasses;
+			bValid = !Ar.IsError();
+
+			if (bValid)
+			{
+				for (int32 i = 0; i < InOutSlots.Num(); ++i)
+					InOutSlots[i] = SnapshotSlots.IsValidIndex(i) ? SnapshotSlots[i] : FInventoryJournalSlotState();
+				LastSequence = SnapshotSequence;
+			}
+			else
+			{
+				OutItemClasses.Reset();
+			}
+		}
+
+		if (!bValid)
+			UE_LOG(LogTemp, Warning, TEXT("库存快照 %s 已损坏，忽略"), *GetSnapshotPath(Name));
+	}
+
+	const FString JournalPath = GetJournalPath(Name);
+	Bytes.Reset();
+	if (!FFileHelper::LoadFileToArray(Bytes, *JournalPath, FILEREAD_Silent))
+		return LastSequence;
+
+	int32 ValidBytes = 0;
+	int32 NumRecords = 0;
+	FDecodedRecord Record;
+	while (ValidBytes + RecordFramingSize <= Bytes.Num())
+	{
+		uint32 PayloadSize = 0;
+		FMemory::Memcpy(&PayloadSize, Bytes.GetData() + ValidBytes, sizeof(uint32));
+		if (PayloadSize > MaxRecordPayloadSize || ValidBytes + RecordFramingSize + static_cast<int64>(PayloadSize) > Bytes.Num()) break;
+
+		const uint8* Payload = Bytes.GetData() + ValidBytes + sizeof(uint32);
+		uint32 StoredChecksum = 0;
+		FMemory::Memcpy(&StoredChecksum, Payload + PayloadSize, sizeof(uint32));
+		if (StoredChecksum != FCrc::MemCrc32(Payload, PayloadSize) || !DecodeRecord(Payload, PayloadSize, Record)) break;
+
+		ValidBytes += RecordFramingSize + PayloadSize;
+		++NumRecords;
+
+		// 类路径与槽位状态无关，快照之前的声明同样保留
+		if (Record.Op == EInventoryJournalOp::DefineItem)
+			OutItemClasses.Add(Record.ItemID, MoveTemp(Record.ClassPath));
+
+		if (Record.Sequence <= LastSequence) continue;
+		LastSequence = Record.Sequence;
+
+		if (!InOutSlots.IsValidIndex(Record.SlotIndex)) continue;
+		switch (Record.Op)
+		{
+		case EInventoryJournalOp::Set:
+			InOutSlots[Record.SlotIndex] = {Record.ItemID, Record.Quantity, MoveTemp(Record.Attributes)};
+			break;
+		case EInventoryJournalOp::Clear:
+			InOutSlots[Record.SlotIndex] = FInventoryJournalSlotState();
+			break;
+		case EInventoryJournalOp::Swap:
+			if (InOutSlots.IsValidIndex(Record.OtherSlotIndex))
+				Swap(InOutSlots[Record.SlotIndex], InOutSlots[Record.OtherSlotIndex]);
+			break;
+		case EInventoryJournalOp::DefineItem:
+			break;
+		}
+	}
+
+	// 崩溃时最后一批记录可能只写了一部分。截断到最后一条有效记录，
+	// 否则之后追加的记录会跟在残缺数据后面，下次重放时同样被丢弃
+	if (ValidBytes < Bytes.Num())
+	{
+		UE_LOG(
+			LogTemp,
+			Warning,
+			TEXT("库存操作日志 %s 在第 %d 条记录处不完整或损坏，丢弃之后的 %d 字节，原文件另存为 .corrupt"),
+			*JournalPath,
+			NumRecords,
+			Bytes.Num() - ValidBytes
+		);
+
+		IFileManager::Get().Copy(*(JournalPath + TEXT(".corrupt")), *JournalPath);
+		Bytes.SetNum(ValidBytes);
+		if (!FFileHelper::SaveArrayToFile(Bytes, *JournalPath))
+			UE_LOG(LogTemp, Error, TEXT("截断库存操作日志 %s 失败"), *JournalPath);
+	}
+
+	return LastSequence;
+}
+
+#pragma endregion
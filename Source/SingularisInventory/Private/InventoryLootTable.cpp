@@ -0,0 +1,198 @@
+/* =====================================================================
+ * InventoryLootTable.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryLootTable.h"
+
+#include "InventoryManager.h"
+#include "SingularisInventory.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	FRandomStream MakeChunkStream(const int32 Seed, const int32 ChunkIndex)
+	{
+		return FRandomStream(static_cast<int32>(HashCombineFast(GetTypeHash(Seed), GetTypeHash(ChunkIndex))));
+	}
+}
+
+void UInventoryLootTable::PostLoad()
+{
+	Super::PostLoad();
+	Compile();
+}
+
+#if WITH_EDITOR
+void UInventoryLootTable::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Compile();
+}
+#endif
+
+void UInventoryLootTable::Compile()
+{
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	// 最后一列为空掉落
+	const int32 NumColumns = Entries.Num() + 1;
+	TArray<double> Scaled;
+	Scaled.SetNumUninitialized(NumColumns);
+
+	double TotalWeight = 0.0;
+	for (int32 i = 0; i < NumColumns; ++i)
+	{
+		const float Weight = i < Entries.Num()
+			? (Entries[i].ItemID != INDEX_NONE ? FMath::Max(Entries[i].Weight, 0.0f) : 0.0f)
+			: FMath::Max(EmptyWeight, 0.0f);
+		Scaled[i] = Weight;
+		TotalWeight += Weight;
+	}
+
+	AliasProbability.Init(1.0f, NumColumns);
+	AliasIndex.SetNumUninitialized(NumColumns);
+	for (int32 i = 0; i < NumColumns; ++i)
+		AliasIndex[i] = i;
+
+	bCompiled = true;
+
+	// 没有任何权重时整张表只产生空掉落
+	if (TotalWeight <= 0.0)
+	{
+		for (int32 i = 0; i < NumColumns; ++i)
+			AliasIndex[i] = Entries.Num();
+		return;
+	}
+
+	TArray<int32> Small;
+	TArray<int32> Large;
+	for (int32 i = 0; i < NumColumns; ++i)
+	{
+		Scaled[i] *= NumColumns / TotalWeight;
+		(Scaled[i] < 1.0 ? Small : Large).Add(i);
+	}
+
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const int32 Less = Small.Pop(EAllowShrinking::No);
+		const int32 More = Large.Pop(EAllowShrinking::No);
+
+		AliasProbability[Less] = static_cast<float>(Scaled[Less]);
+		AliasIndex[Less] = More;
+
+		Scaled[More] = Scaled[More] + Scaled[Less] - 1.0;
+		(Scaled[More] < 1.0 ? Small : Large).Add(More);
+	}
+
+	// 剩余列的概率因浮点误差略偏离 1，直接视为 1
+	for (const int32 Index : Large)
+		AliasProbability[Index] = 1.0f;
+	for (const int32 Index : Small)
+		AliasProbability[Index] = 1.0f;
+}
+
+void UInventoryLootTable::EnsureCompiled()
+{
+	if (!bCompiled)
+		Compile();
+}
+
+int32 UInventoryLootTable::SampleEntry(const FRandomStream& Random) const
+{
+	// 均匀选择一列，再按该列的概率决定保留本列还是取别名列
+	const int32 NumColumns = AliasProbability.Num();
+	const float Roll = Random.GetFraction() * NumColumns;
+	const int32 Column = FMath::Min(FMath::FloorToInt32(Roll), NumColumns - 1);
+	return Roll - Column < AliasProbability[Column] ? Column : AliasIndex[Column];
+}
+
+int32 UInventoryLootTable::SampleQuantity(const FInventoryLootEntry& Entry, const FRandomStream& Random)
+{
+	const int32 MinQuantity = FMath::Max(Entry.MinQuantity, 1);
+	return Random.RandRange(MinQuantity, FMath::Max(Entry.MaxQuantity, MinQuantity));
+}
+
+FInventoryLootDrop UInventoryLootTable::Sample(const FRandomStream& Random) const
+{
+	FInventoryLootDrop Drop;
+	if (!ensureMsgf(bCompiled, TEXT("掉落表 %s 尚未编译"), *GetName())) return Drop;
+
+	const int32 EntryIndex = SampleEntry(Random);
+	if (!Entries.IsValidIndex(EntryIndex)) return Drop;
+
+	Drop.ItemID = Entries[EntryIndex].ItemID;
+	Drop.Quantity = SampleQuantity(Entries[EntryIndex], Random);
+	return Drop;
+}
+
+void UInventoryLootTable::SampleDrops(const int32 NumDraws, const int32 Seed, TArray<FInventoryLootDrop>& OutDrops)
+{
+	OutDrops.Reset();
+	if (NumDraws <= 0) return;
+
+	EnsureCompiled();
+	OutDrops.SetNumUninitialized(NumDraws);
+
+	// 每块写入输出数组中互不重叠的区间
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumDraws, DrawsPerChunk);
+	ParallelFor(NumChunks, [this, NumDraws, Seed, &OutDrops](const int32 ChunkIndex)
+	{
+		const FRandomStream Random = MakeChunkStream(Seed, ChunkIndex);
+		const int32 Begin = ChunkIndex * DrawsPerChunk;
+		const int32 End = FMath::Min(Begin + DrawsPerChunk, NumDraws);
+		for (int32 i = Begin; i < End; ++i)
+			OutDrops[i] = Sample(Random);
+	}, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void UInventoryLootTable::SampleTotals(const int32 NumDraws, const int32 Seed, TArray<TPair<int32, int32>>& OutItemCounts)
+{
+	OutItemCounts.Reset();
+	if (NumDraws <= 0) return;
+
+	EnsureCompiled();
+
+	// 每块按条目累计数量，最后合并；与 SampleDrops 使用相同的随机流，结果一致
+	const int32 NumEntries = Entries.Num();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumDraws, DrawsPerChunk);
+	TArray<int64> ChunkTotals;
+	ChunkTotals.SetNumZeroed(NumChunks * NumEntries);
+
+	ParallelFor(NumChunks, [this, NumDraws, Seed, NumEntries, &ChunkTotals](const int32 ChunkIndex)
+	{
+		const FRandomStream Random = MakeChunkStream(Seed, ChunkIndex);
+		int64* Totals = ChunkTotals.GetData() + ChunkIndex * NumEntries;
+
+		const int32 Begin = ChunkIndex * DrawsPerChunk;
+		const int32 End = FMath::Min(Begin + DrawsPerChunk, NumDraws);
+		for (int32 i = Begin; i < End; ++i)
+		{
+			const int32 EntryIndex = SampleEntry(Random);
+			if (EntryIndex < NumEntries)
+				Totals[EntryIndex] += SampleQuantity(Entries[EntryIndex], Random);
+		}
+	}, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	for (int32 EntryIndex = 0; EntryIndex < NumEntries; ++EntryIndex)
+	{
+		int64 Total = 0;
+		for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+			Total += ChunkTotals[ChunkIndex * NumEntries + EntryIndex];
+		if (Total > 0)
+			OutItemCounts.Emplace(Entries[EntryIndex].ItemID, static_cast<int32>(FMath::Min<int64>(Total, MAX_int32)));
+	}
+}
+
+int32 UInventoryLootTable::GrantTo(UInventoryManager* Inventory, const int32 NumDraws, const int32 Seed)
+{
+	if (!Inventory) return 0;
+
+	TArray<TPair<int32, int32>> ItemCounts;
+	SampleTotals(NumDraws, Seed, ItemCounts);
+	return Inventory->TryAddItemBatch(ItemCounts);
+}
@@ -9,15 +9,43 @@
 
 #include <EnhancedInputComponent.h>
 #include <EnhancedInputSubsystems.h>
+#include <Async/Async.h>
 #include <Blueprint/UserWidget.h>
+#include <GameFramework/Pawn.h>
+#include <GameFramework/PlayerController.h>
 
 #include "InventoryManager.h"
+#include "BaseItem.h"
+#include "InventoryItemRegistry.h"
+#include "InventoryJournal.h"
+#include "InventorySearchIndex.h"
+#include "InventorySnapshot.h"
 #include "InventoryWidget.h"
+#include "SingularisInventory.h"
+
+void FInventorySlot::SetItem(UBaseItem* NewItem, const int32 NewQuantity)
+{
+	Item = NewItem;
+	ItemID = NewItem ? NewItem->ItemID : INDEX_NONE;
+	Quantity = NewQuantity;
+	Attributes.Reset();
+	bIsEmpty = false;
+}
+
+UBaseItem* FInventorySlot::GetItem() const
+{
+	if (Item || bIsEmpty) return Item;
+
+	const UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	return Registry ? Registry->FindItemDefinition(ItemID) : nullptr;
+}
 
 UInventoryManager::UInventoryManager()
 {
 	PrimaryComponentTick.bCanEverTick = true;
 
+	// 服务器构建不需要界面与输入资源，跳过加载
+#if !UE_SERVER
 	static ConstructorHelpers::FClassFinder<UInventoryWidget> WidgetClassFinder(
 		TEXT("/SingularisInventory/UserInterface/WBP_DefaultInventory")
 	);
@@ -25,13 +53,38 @@ UInventoryManager::UInventoryManager()
 		InventoryWidgetClass = WidgetClassFinder.Class;
 
 	InputFinder();
+#endif
 }
 
 void UInventoryManager::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
 	Super::BeginPlay();
-	CreateInteractionWidget();
-	BindInputs();
+
+	// 编辑器中配置的初始物品只设置了 Item，这里补齐 ItemID 与数量
+	TrackedItemBytes = 0;
+	for (FInventorySlot& Slot : Slots)
+	{
+		if (Slot.Item && (Slot.bIsEmpty || Slot.Quantity <= 0))
+			Slot.SetItem(Slot.Item, FMath::Max(Slot.Quantity, 1));
+		TrackedItemBytes += EstimateSlotBytes(Slot);
+	}
+
+	if (!JournalName.IsEmpty())
+		RestoreFromJournal();
+
+	RebuildSearchIndex();
+
+	SnapshotPublisher = MakeShared<FInventorySnapshotPublisher, ESPMode::ThreadSafe>();
+	SnapshotPublisher->Publish(Slots);
+
+	// 拥有者为 Pawn 时可能在开始游戏之后才被控制（延迟生成、重生、客户端复制），
+	// 控制器变化时再创建界面与绑定输入
+	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+		OwnerPawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &UInventoryManager::HandleControllerChanged);
+
+	UpdatePresentation();
 }
 
 void UInventoryManager::OnRegister()
@@ -45,66 +98,335 @@ void UInventoryManager::OnRegister()
 		return;
 	}
 
-	// 阶段2：类型安全验证
-	PlayerController = Cast<APlayerController>(GetOwner());
-	if (!PlayerController.IsValid())
+	// 阶段2：解析玩家控制器。库存可以挂在任意 Actor 上（NPC、箱子等），
+	// 没有本地玩家控制器时只运行库存逻辑，不创建界面也不绑定输入
+	PlayerController = ResolvePlayerController();
+
+	// 初始化成功逻辑
+	SetComponentTickEnabled(true);
+}
+
+void UInventoryManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (APawn* OwnerPawn = Cast<APawn>(GetOwner()))
+		OwnerPawn->ReceiveControllerChangedDelegate.RemoveDynamic(this, &UInventoryManager::HandleControllerChanged);
+
+	// 剩余记录交给共享写入线程写出，结束游戏时不在游戏线程等待磁盘写入
+	FInventoryJournal::Close(MoveTemp(Journal));
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInventoryManager::GetJournalSlotStates(TArray<FInventoryJournalSlotState>& OutStates) const
+{
+	OutStates.SetNum(Slots.Num());
+	for (int32 i = 0; i < Slots.Num(); ++i)
+		OutStates[i] = Slots[i].bIsEmpty
+			? FInventoryJournalSlotState()
+			: FInventoryJournalSlotState{Slots[i].ItemID, Slots[i].Quantity, Slots[i].Attributes};
+}
+
+void UInventoryManager::RestoreFromJournal()
+{
+	TArray<FInventoryJournalSlotState> States;
+	GetJournalSlotStates(States);
+
+	TMap<int32, FString> ItemClasses;
+	const uint64 LastSequence = FInventoryJournal::Replay(JournalName, States, ItemClasses);
+
+	// 有持久化数据时以其为准；恢复出的物品按紧凑方式存放，由注册表提供物品定义。
+	// 日志不保存物品实例对象的属性，只有紧凑存储是无损恢复，实例存储的逐实例状态需放在槽位实例属性中
+	if (LastSequence > 0)
 	{
-		const FString OwnerInfo = FString::Printf(
-			TEXT("%s (Class: %s)"),
-			*GetOwner()->GetName(),
-			*GetOwner()->GetClass()->GetName()
-		);
-
-		// 增强错误报告
-		ensureMsgf(
-			false,
-			TEXT("[%s] 必须附加到APlayerController! 当前附加到: %s"),
-			*GetFullName(),
-			*OwnerInfo
-		);
-
-		UE_LOG(
-			LogTemp,
-			Error,
-			TEXT("[%s] 附加到非法对象 %s. 组件功能已禁用."),
-			*GetFullName(),
-			*OwnerInfo
-		);
-
-		// 彻底禁用
-		SetComponentTickEnabled(false);
-		PrimaryComponentTick.bCanEverTick = false;
-		SetActive(false, true);
+		TrackedItemBytes = 0;
+		for (int32 i = 0; i < Slots.Num(); ++i)
+		{
+			FInventorySlot& Slot = Slots[i];
+			const FInventoryJournalSlotState& State = States[i];
+			if (!Slot.bIsEmpty && Slot.ItemID == State.ItemID && Slot.Quantity == State.Quantity && Slot.Attributes == State.Attributes)
+			{
+				TrackedItemBytes += EstimateSlotBytes(Slot);
+				continue;
+			}
+
+			Slot.Clear();
+			if (State.ItemID == INDEX_NONE || State.Quantity <= 0) continue;
+
+			// 物品类暂时无法解析时同样保留 ItemID 与数量，之后注册了该 ItemID 即可正常显示和使用，
+			// 再次写入快照时类路径也会随类表一并保留
+			Slot.SetItemID(State.ItemID, State.Quantity);
+			Slot.Attributes = State.Attributes;
+			TrackedItemBytes += EstimateSlotBytes(Slot);
+			if (!ResolveJournalDefinition(State.ItemID, ItemClasses))
+				UE_LOG(
+					LogTemp,
+					Error,
+					TEXT("[%s] 恢复槽位 %d 时无法解析物品ID %d 的物品类（%s），已保留槽位数据"),
+					*GetFullName(),
+					i,
+					State.ItemID,
+					ItemClasses.Contains(State.ItemID) ? *ItemClasses[State.ItemID] : TEXT("未记录")
+				);
+		}
+	}
+
+	Journal = FInventoryJournal::Open(JournalName, LastSequence + 1, MoveTemp(ItemClasses));
+}
 
+const UBaseItem* UInventoryManager::ResolveJournalDefinition(const int32 ItemID, const TMap<int32, FString>& ItemClasses)
+{
+	UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	if (!Registry) return nullptr;
+
+	if (const UBaseItem* Definition = Registry->FindItemDefinition(ItemID))
+		return Definition;
+
+	// 实例存储的物品不会预先注册，按日志中记录的类路径加载物品类并以记录的 ItemID 注册
+	const FString* ClassPath = ItemClasses.Find(ItemID);
+	UClass* ItemClass = ClassPath ? LoadClass<UBaseItem>(nullptr, **ClassPath) : nullptr;
+	if (!ItemClass || ItemClass->HasAnyClassFlags(CLASS_Abstract)) return nullptr;
+
+	Registry->RegisterItemDefinition(ItemID, ItemClass->GetDefaultObject<UBaseItem>());
+	return Registry->FindItemDefinition(ItemID);
+}
+
+APlayerController* UInventoryManager::ResolvePlayerController() const
+{
+	AActor* Owner = GetOwner();
+	if (APlayerController* OwnerController = Cast<APlayerController>(Owner))
+		return OwnerController;
+	if (const APawn* OwnerPawn = Cast<APawn>(Owner))
+		return OwnerPawn->GetController<APlayerController>();
+	return nullptr;
+}
+
+bool UInventoryManager::ShouldCreatePresentation() const
+{
+#if UE_SERVER
+	return false;
+#else
+	if (IsNetMode(NM_DedicatedServer) || IsRunningDedicatedServer()) return false;
+	return PlayerController.IsValid() && PlayerController->IsLocalController();
+#endif
+}
+
+void UInventoryManager::UpdatePresentation()
+{
+	PlayerController = ResolvePlayerController();
+
+	if (!ShouldCreatePresentation())
+	{
+		// 失去本地控制（例如被 AI 接管或玩家切换到其他 Pawn）时撤下界面与输入
+		if (InventoryWidget)
+		{
+			InventoryWidget->RemoveFromParent();
+			InventoryWidget = nullptr;
+		}
+		UnbindInputs();
 		return;
 	}
 
-	// 后置验证
-	checkf(
-		PlayerController->IsLocalController(),
-		TEXT("库存组件只能用于本地控制者: %s"),
-		*GetFullName()
-	);
+	if (bCreateWidget && !InventoryWidget)
+		CreateInteractionWidget();
 
-	// 初始化成功逻辑
-	SetComponentTickEnabled(true);
+	if (bBindInput && InputBoundController != PlayerController)
+	{
+		UnbindInputs();
+		BindInputs();
+	}
+}
+
+void UInventoryManager::HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	if (HasBegunPlay())
+		UpdatePresentation();
 }
 
 void UInventoryManager::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UseCooldowns.Advance(DeltaTime);
+
+	if (PendingUses.Num() > 0)
+		ProcessUseRequests();
+
+	PublishSnapshot();
+}
+
+void UInventoryManager::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	if (CumulativeResourceSize.GetResourceSizeMode() == EResourceSizeMode::Exclusive)
+	{
+		SIZE_T Bytes = sizeof(*this) + Slots.GetAllocatedSize();
+		for (const FInventorySlot& Slot : Slots)
+			Bytes += Slot.Attributes.GetAllocatedSize();
+		if (SearchIndex.IsValid())
+			Bytes += sizeof(FInventorySearchIndex) + SearchIndex->GetAllocatedSize();
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Bytes);
+	}
 }
 
 void UInventoryManager::CreateInteractionWidget()
 {
+#if !UE_SERVER
 	InventoryWidget = CreateWidget<UInventoryWidget>(PlayerController.Get(), InventoryWidgetClass);
 
 	if (InventoryWidget)
 	{
 		InventoryWidget->AddToViewport(10);
-		InventoryWidget->SetSlotCount(Slots.Num());
-		InventoryWidget->SetSlotSelect(SlotSelect);
+		InventoryWidget->BindInventory(this);
+	}
+	if (UInventoryWidget* EventWidget = GetSlotEventWidget())
+	{
+		EventWidget->SetSlotCount(Slots.Num());
+		EventWidget->SetSlotSelect(SlotSelect);
 	}
+#endif
+}
+
+UInventoryWidget* UInventoryManager::GetSlotEventWidget() const
+{
+	return InventoryWidget && !InventoryWidget->bUseNativeSlotGrid ? InventoryWidget : nullptr;
+}
+
+void UInventoryManager::NotifySlotChanged(const int32 SlotIndex, const bool bJournal)
+{
+	if (Journal.IsValid() && bJournal)
+	{
+		const FInventorySlot& Slot = Slots[SlotIndex];
+		if (Slot.bIsEmpty)
+			Journal->RecordClear(SlotIndex);
+		else if (const UBaseItem* Item = Slot.GetItem())
+			Journal->RecordSet(SlotIndex, Slot.ItemID, Slot.Quantity, Slot.Attributes, Item->GetClass());
+		else
+			Journal->RecordSet(SlotIndex, Slot.ItemID, Slot.Quantity, Slot.Attributes, nullptr);
+	}
+
+	if (SearchIndex.IsValid())
+		SearchIndex->UpdateSlot(SlotIndex, Slots[SlotIndex].GetItem());
+
+	if (SnapshotPublisher.IsValid())
+		SnapshotPublisher->MarkDirty(SlotIndex);
+
+	OnSlotChangedNative.Broadcast(this, SlotIndex);
+	OnSlotUpdated.Broadcast(SlotIndex);
+}
+
+bool UInventoryManager::ShouldStoreCompact(const UBaseItem* Item) const
+{
+	// 紧凑存储只保留 ItemID，物品定义交由注册表持有；没有同类定义时退回实例存储
+	UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	if (!Registry || ItemStorage != EInventoryItemStorage::Compact) return false;
+
+	Registry->RegisterItemClass(Item->GetClass());
+	const UBaseItem* Definition = Registry->FindItemDefinition(Item->ItemID);
+	return Definition && Definition->GetClass() == Item->GetClass();
+}
+
+int32 UInventoryManager::FindStackSlot(
+	const int32 ItemID,
+	const int32 MaxStackSize,
+	const FInventoryItemAttributes& Attributes
+) const
+{
+	if (MaxStackSize <= 1) return INDEX_NONE;
+
+	// 只与同 ID 且实例属性相同的紧凑槽位堆叠，实例存储的槽位各自持有独立的物品状态
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		const FInventorySlot& Slot = Slots[i];
+		if (!Slot.bIsEmpty && !Slot.Item && Slot.ItemID == ItemID && Slot.Quantity < MaxStackSize && Slot.Attributes == Attributes)
+			return i;
+	}
+	return INDEX_NONE;
+}
+
+void UInventoryManager::StoreItem(
+	const int32 SlotIndex,
+	UBaseItem* Item,
+	const bool bCompact,
+	const FInventoryItemAttributes& Attributes
+)
+{
+	if (bCompact)
+		Slots[SlotIndex].SetItemID(Item->ItemID);
+	else
+		Slots[SlotIndex].SetItem(Item);
+	Slots[SlotIndex].Attributes = Attributes;
+	TrackedItemBytes += EstimateSlotBytes(Slots[SlotIndex]);
+
+	RefreshSlotWidget(SlotIndex);
+	NotifySlotChanged(SlotIndex);
+}
+
+void UInventoryManager::RefreshSlotWidget(const int32 SlotIndex) const
+{
+	UInventoryWidget* EventWidget = GetSlotEventWidget();
+	if (!EventWidget) return;
+
+	if (Slots[SlotIndex].bIsEmpty)
+		EventWidget->ClearSlotItem(SlotIndex);
+	else
+		EventWidget->SetSlotItem(SlotIndex, Slots[SlotIndex].GetItem());
+}
+
+void UInventoryManager::MarkSlotDirty(const int32 SlotIndex)
+{
+	if (DirtySlotMask.Num() < Slots.Num())
+		DirtySlotMask.SetNum(Slots.Num(), false);
+
+	if (DirtySlotMask[SlotIndex]) return;
+	DirtySlotMask[SlotIndex] = true;
+	DirtySlots.Add(SlotIndex);
+}
+
+void UInventoryManager::FlushDirtySlots()
+{
+	for (const int32 SlotIndex : DirtySlots)
+	{
+		DirtySlotMask[SlotIndex] = false;
+		if (!Slots.IsValidIndex(SlotIndex)) continue;
+
+		RefreshSlotWidget(SlotIndex);
+		NotifySlotChanged(SlotIndex);
+	}
+	DirtySlots.Reset();
+}
+
+bool UInventoryManager::CheckMemoryBudget(const UBaseItem* Item, const int64 AddedBytes) const
+{
+	if (MemoryBudgetBytes <= 0) return true;
+
+	// 不新增字节的操作（堆叠、无属性的紧凑槽位）在已经超出预算时同样受策略约束
+	const int64 NewBytes = TrackedItemBytes + AddedBytes;
+	if (NewBytes <= MemoryBudgetBytes) return true;
+
+	UE_LOG(
+		LogTemp,
+		Warning,
+		TEXT("[%s] 添加物品 %s 后内存占用 %lld 字节，超出预算 %lld 字节%s"),
+		*GetFullName(),
+		*GetNameSafe(Item),
+		NewBytes,
+		MemoryBudgetBytes,
+		BudgetPolicy == EInventoryBudgetPolicy::Reject ? TEXT("，已拒绝添加") : TEXT("")
+	);
+
+	return BudgetPolicy != EInventoryBudgetPolicy::Reject;
+}
+
+int64 UInventoryManager::EstimateItemBytes(const UBaseItem* Item)
+{
+	return Item ? static_cast<int64>(const_cast<UBaseItem*>(Item)->GetResourceSizeBytes(EResourceSizeMode::Exclusive)) : 0;
+}
+
+int64 UInventoryManager::EstimateSlotBytes(const FInventorySlot& Slot)
+{
+	// 紧凑槽位不持有物品实例，只计入溢出到堆上的实例属性
+	return EstimateItemBytes(Slot.Item) + static_cast<int64>(Slot.Attributes.GetAllocatedSize());
 }
 
 void UInventoryManager::InputFinder()
@@ -135,6 +457,7 @@ void UInventoryManager::LoadInputAction(UInputAction*& InputAction, const TCHAR*
 
 void UInventoryManager::BindInputs()
 {
+#if !UE_SERVER
 	if (!InventoryInputMappingContext || !InventoryInputActionOne || !InventoryInputActionTwo || !InventoryInputActionThree || !
 		InventoryInputActionFour
 		|| !InventoryInputActionFive || !InventoryInputActionSix || !InventoryInputActionSeven || !InventoryInputActionEight || !
@@ -162,6 +485,26 @@ void UInventoryManager::BindInputs()
 		EnhancedInput->BindAction(InventoryInputActionNine, ETriggerEvent::Triggered, this, &UInventoryManager::HandleNine);
 		EnhancedInput->BindAction(InventoryInputActionZero, ETriggerEvent::Triggered, this, &UInventoryManager::HandleZero);
 	}
+
+	InputBoundController = PlayerController;
+#endif
+}
+
+void UInventoryManager::UnbindInputs()
+{
+#if !UE_SERVER
+	APlayerController* BoundController = InputBoundController.Get();
+	InputBoundController = nullptr;
+	if (!BoundController) return;
+
+	if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(
+		BoundController->GetLocalPlayer()
+	))
+		Subsystem->RemoveMappingContext(InventoryInputMappingContext);
+
+	if (UEnhancedInputComponent* EnhancedInput = Cast<UEnhancedInputComponent>(BoundController->InputComponent))
+		EnhancedInput->ClearBindingsForObject(this);
+#endif
 }
 
 void UInventoryManager::HandleOne(const FInputActionValue& Value)
@@ -219,27 +562,237 @@ void UInventoryManager::HandleZero(const FInputActionValue& Value)
 #pragma region 库存操作函数
 
 bool UInventoryManager::TryAddItem(UBaseItem* Item)
+{
+	return TryAddItemInstance(Item, FInventoryItemAttributes::Empty);
+}
+
+bool UInventoryManager::TryAddItemInstance(UBaseItem* Item, const FInventoryItemAttributes& Attributes)
 {
 	if (!Item) return false;
 
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	const bool bCompact = ShouldStoreCompact(Item);
+
+	// 紧凑存储优先堆叠到已有槽位；实例存储的每个实例独占一个槽位，与引入堆叠之前一致
+	if (const int32 StackSlot = bCompact ? FindStackSlot(Item->ItemID, Item->MaxStackSize, Attributes) : INDEX_NONE; StackSlot != INDEX_NONE)
+	{
+		if (!CheckMemoryBudget(Item, 0)) return false;
+
+		++Slots[StackSlot].Quantity;
+		RefreshSlotWidget(StackSlot);
+		NotifySlotChanged(StackSlot);
+		return true;
+	}
+
 	for (int32 i = 0; i < Slots.Num(); ++i)
 		if (Slots[i].bIsEmpty)
 		{
-			Slots[i].SetItem(Item);
-			InventoryWidget->SetSlotItem(i, Item);
-			OnSlotUpdated.Broadcast(i);
+			const int64 AddedBytes = (bCompact ? 0 : EstimateItemBytes(Item)) + static_cast<int64>(Attributes.GetAllocatedSize());
+			if (!CheckMemoryBudget(Item, AddedBytes)) return false;
+
+			StoreItem(i, Item, bCompact, Attributes);
 			return true;
 		}
 	return false;
 }
 
+bool UInventoryManager::TryAddItemByID(const int32 ItemID)
+{
+	return TryAddItemWithAttributes(ItemID, FInventoryItemAttributes::Empty);
+}
+
+bool UInventoryManager::TryAddItemWithAttributes(const int32 ItemID, const FInventoryItemAttributes& Attributes)
+{
+	const UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	const UBaseItem* Definition = Registry ? Registry->FindItemDefinition(ItemID) : nullptr;
+	if (!Definition) return false;
+
+	if (const int32 StackSlot = FindStackSlot(ItemID, Definition->MaxStackSize, Attributes); StackSlot != INDEX_NONE)
+	{
+		if (!CheckMemoryBudget(Definition, 0)) return false;
+
+		++Slots[StackSlot].Quantity;
+		RefreshSlotWidget(StackSlot);
+		NotifySlotChanged(StackSlot);
+		return true;
+	}
+
+	for (int32 i = 0; i < Slots.Num(); ++i)
+		if (Slots[i].bIsEmpty)
+		{
+			if (!CheckMemoryBudget(Definition, static_cast<int64>(Attributes.GetAllocatedSize()))) return false;
+
+			Slots[i].SetItemID(ItemID);
+			Slots[i].Attributes = Attributes;
+			TrackedItemBytes += EstimateSlotBytes(Slots[i]);
+			RefreshSlotWidget(i);
+			NotifySlotChanged(i);
+			return true;
+		}
+	return false;
+}
+
+int32 UInventoryManager::TryAddItemsByID(const int32 ItemID, const int32 Count)
+{
+	const int32 Added = AddItemsByIDDeferred(ItemID, Count);
+	FlushDirtySlots();
+	return Added;
+}
+
+int32 UInventoryManager::TryAddItemBatch(const TConstArrayView<TPair<int32, int32>> ItemCounts)
+{
+	int32 Added = 0;
+	for (const TPair<int32, int32>& Pair : ItemCounts)
+		Added += AddItemsByIDDeferred(Pair.Key, Pair.Value);
+	FlushDirtySlots();
+	return Added;
+}
+
+int32 UInventoryManager::AddItemsByIDDeferred(const int32 ItemID, const int32 Count)
+{
+	const UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	const UBaseItem* Definition = Registry ? Registry->FindItemDefinition(ItemID) : nullptr;
+	if (!Definition || Count <= 0) return 0;
+
+	// 批量添加的紧凑槽位不带实例属性，不新增估算字节；已经超出预算时按策略整体拒绝
+	if (!CheckMemoryBudget(Definition, 0)) return 0;
+
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	const int32 MaxStackSize = FMath::Max(Definition->MaxStackSize, 1);
+	int32 Remaining = Count;
+
+	// 第一遍填满已有的紧凑堆叠，第二遍占用空槽位，与逐个 TryAddItemByID 的结果一致
+	if (MaxStackSize > 1)
+		for (int32 i = 0; i < Slots.Num() && Remaining > 0; ++i)
+		{
+			FInventorySlot& Slot = Slots[i];
+			if (Slot.bIsEmpty || Slot.ItemID != ItemID || Slot.Item || !Slot.Attributes.IsEmpty() || Slot.Quantity >= MaxStackSize) continue;
+
+			const int32 Added = FMath::Min(Remaining, MaxStackSize - Slot.Quantity);
+			Slot.Quantity += Added;
+			Remaining -= Added;
+			MarkSlotDirty(i);
+		}
+
+	for (int32 i = 0; i < Slots.Num() && Remaining > 0; ++i)
+	{
+		if (!Slots[i].bIsEmpty) continue;
+
+		const int32 Added = FMath::Min(Remaining, MaxStackSize);
+		Slots[i].SetItemID(ItemID, Added);
+		Remaining -= Added;
+		MarkSlotDirty(i);
+	}
+
+	return Count - Remaining;
+}
+
+TSharedPtr<const FInventorySnapshot, ESPMode::ThreadSafe> UInventoryManager::GetSnapshot() const
+{
+	if (!SnapshotPublisher.IsValid()) return nullptr;
+	return SnapshotPublisher->GetLatest();
+}
+
+void UInventoryManager::PublishSnapshot()
+{
+	if (SnapshotPublisher.IsValid() && SnapshotPublisher->HasPendingChanges())
+		SnapshotPublisher->Publish(Slots);
+}
+
+void UInventoryManager::SaveJournalSnapshot()
+{
+	if (!Journal.IsValid()) return;
+
+	TArray<FInventoryJournalSlotState> States;
+	GetJournalSlotStates(States);
+	Journal->WriteSnapshot(States);
+}
+
+int32 UInventoryManager::GetSlotAttribute(const int32 SlotIndex, const FName Key, const int32 DefaultValue) const
+{
+	return Slots.IsValidIndex(SlotIndex) ? Slots[SlotIndex].Attributes.Get(Key, DefaultValue) : DefaultValue;
+}
+
+bool UInventoryManager::SetSlotAttribute(const int32 SlotIndex, const FName Key, const int32 Value)
+{
+	if (!Slots.IsValidIndex(SlotIndex) || Slots[SlotIndex].bIsEmpty || Key.IsNone()) return false;
+
+	// 属性超出内联容量时会溢出到堆上，先在副本上修改以便按预算拒绝
+	FInventorySlot& Slot = Slots[SlotIndex];
+	FInventoryItemAttributes NewAttributes = Slot.Attributes;
+	NewAttributes.Set(Key, Value);
+	const int64 AddedBytes = static_cast<int64>(NewAttributes.GetAllocatedSize()) - static_cast<int64>(Slot.Attributes.GetAllocatedSize());
+	if (AddedBytes > 0 && !CheckMemoryBudget(Slot.GetItem(), AddedBytes)) return false;
+
+	TrackedItemBytes += AddedBytes;
+	Slot.Attributes = MoveTemp(NewAttributes);
+	NotifySlotChanged(SlotIndex);
+	return true;
+}
+
+bool UInventoryManager::RemoveSlotAttribute(const int32 SlotIndex, const FName Key)
+{
+	if (!Slots.IsValidIndex(SlotIndex)) return false;
+
+	FInventoryItemAttributes& Attributes = Slots[SlotIndex].Attributes;
+	const int64 OldBytes = static_cast<int64>(Attributes.GetAllocatedSize());
+	if (!Attributes.Remove(Key)) return false;
+	TrackedItemBytes += static_cast<int64>(Attributes.GetAllocatedSize()) - OldBytes;
+
+	NotifySlotChanged(SlotIndex);
+	return true;
+}
+
 bool UInventoryManager::RemoveItemByIndex(const int32 SlotIndex)
 {
 	if (!Slots.IsValidIndex(SlotIndex)) return false;
 
+	TrackedItemBytes -= EstimateSlotBytes(Slots[SlotIndex]);
 	Slots[SlotIndex].Clear();
-	InventoryWidget->ClearSlotItem(SlotIndex);
-	OnSlotUpdated.Broadcast(SlotIndex);
+	if (UInventoryWidget* EventWidget = GetSlotEventWidget())
+		EventWidget->ClearSlotItem(SlotIndex);
+	NotifySlotChanged(SlotIndex);
+	return true;
+}
+
+bool UInventoryManager::RemoveItemCount(const int32 SlotIndex, const int32 Count)
+{
+	if (!Slots.IsValidIndex(SlotIndex) || Slots[SlotIndex].bIsEmpty || Count <= 0) return false;
+	if (Slots[SlotIndex].Quantity < Count) return false;
+	if (Slots[SlotIndex].Quantity == Count) return RemoveItemByIndex(SlotIndex);
+
+	Slots[SlotIndex].Quantity -= Count;
+	RefreshSlotWidget(SlotIndex);
+	NotifySlotChanged(SlotIndex);
+	return true;
+}
+
+int32 UInventoryManager::RemoveItemCountBatch(const TConstArrayView<TPair<int32, int32>> SlotCounts)
+{
+	int32 Removed = 0;
+	for (const TPair<int32, int32>& Pair : SlotCounts)
+		if (RemoveItemCountDeferred(Pair.Key, Pair.Value))
+			Removed += Pair.Value;
+	FlushDirtySlots();
+	return Removed;
+}
+
+bool UInventoryManager::RemoveItemCountDeferred(const int32 SlotIndex, const int32 Count)
+{
+	if (!Slots.IsValidIndex(SlotIndex) || Slots[SlotIndex].bIsEmpty || Count <= 0) return false;
+
+	FInventorySlot& Slot = Slots[SlotIndex];
+	if (Slot.Quantity < Count) return false;
+
+	Slot.Quantity -= Count;
+	if (Slot.Quantity == 0)
+	{
+		TrackedItemBytes -= EstimateSlotBytes(Slot);
+		Slot.Clear();
+	}
+	MarkSlotDirty(SlotIndex);
 	return true;
 }
 
@@ -248,10 +801,25 @@ void UInventoryManager::SwapSlots(const int32 FromIndex, const int32 ToIndex)
 	if (!Slots.IsValidIndex(FromIndex) || !Slots.IsValidIndex(ToIndex)) return;
 
 	Swap(Slots[FromIndex], Slots[ToIndex]);
-	InventoryWidget->SetSlotItem(FromIndex, Slots[ToIndex].Item);
-	InventoryWidget->SetSlotItem(ToIndex, Slots[FromIndex].Item);
-	OnSlotUpdated.Broadcast(FromIndex);
-	OnSlotUpdated.Broadcast(ToIndex);
+	if (UInventoryWidget* EventWidget = GetSlotEventWidget())
+	{
+		EventWidget->SetSlotItem(FromIndex, Slots[FromIndex].GetItem());
+		EventWidget->SetSlotItem(ToIndex, Slots[ToIndex].GetItem());
+	}
+	if (Journal.IsValid())
+		Journal->RecordSwap(FromIndex, ToIndex);
+	NotifySlotChanged(FromIndex, false);
+	NotifySlotChanged(ToIndex, false);
+}
+
+void UInventoryManager::RestoreSlot(const int32 SlotIndex, const FInventorySlot& Slot)
+{
+	if (!Slots.IsValidIndex(SlotIndex)) return;
+
+	TrackedItemBytes += EstimateSlotBytes(Slot) - EstimateSlotBytes(Slots[SlotIndex]);
+	Slots[SlotIndex] = Slot;
+	RefreshSlotWidget(SlotIndex);
+	NotifySlotChanged(SlotIndex);
 }
 
 bool UInventoryManager::IsSlotEmpty(const int32 SlotIndex) const
@@ -261,7 +829,7 @@ bool UInventoryManager::IsSlotEmpty(const int32 SlotIndex) const
 
 UBaseItem* UInventoryManager::GetItemInSlot(const int32 SlotIndex) const
 {
-	return Slots.IsValidIndex(SlotIndex) ? Slots[SlotIndex].Item : nullptr;
+	return Slots.IsValidIndex(SlotIndex) ? Slots[SlotIndex].GetItem() : nullptr;
 }
 
 UBaseItem* UInventoryManager::GetSelectItem() const
@@ -274,8 +842,176 @@ void UInventoryManager::SetSlotSelect(const int32 Index)
 	// SlotSelect = FMath::Clamp(Index, 0, Slots.Num() - 1);
 	if (Index == SlotSelect || !Slots.IsValidIndex(Index)) return;
 	SlotSelect = Index;
-	InventoryWidget->SetSlotSelect(SlotSelect);
+	if (UInventoryWidget* EventWidget = GetSlotEventWidget())
+		EventWidget->SetSlotSelect(SlotSelect);
+	OnSlotSelectChangedNative.Broadcast(this, SlotSelect);
 	OnSlotUpdated.Broadcast(SlotSelect);
 }
 
 #pragma endregion
+
+#pragma region 库存使用函数
+
+bool UInventoryManager::UseItem(const int32 SlotIndex)
+{
+	if (!Slots.IsValidIndex(SlotIndex) || Slots[SlotIndex].bIsEmpty) return false;
+	if (UseCooldowns.IsCoolingDown(Slots[SlotIndex].ItemID)) return false;
+
+	PendingUses.Add({SlotIndex, Slots[SlotIndex].ItemID});
+	return true;
+}
+
+int32 UInventoryManager::UseItems(const TArray<int32>& SlotIndices)
+{
+	int32 Accepted = 0;
+	for (const int32 SlotIndex : SlotIndices)
+		Accepted += UseItem(SlotIndex) ? 1 : 0;
+	return Accepted;
+}
+
+float UInventoryManager::GetItemCooldownRemaining(const int32 ItemID) const
+{
+	return UseCooldowns.GetRemaining(ItemID);
+}
+
+void UInventoryManager::ProcessUseRequests()
+{
+	APlayerController* User = PlayerController.Get();
+
+	for (int32 i = 0; i < PendingUses.Num(); ++i)
+	{
+		const FUseRequest Request = PendingUses[i];
+
+		// 排队期间槽位内容可能已被移动或消耗完
+		if (!Slots.IsValidIndex(Request.SlotIndex)) continue;
+		FInventorySlot& Slot = Slots[Request.SlotIndex];
+		if (Slot.bIsEmpty || Slot.ItemID != Request.ItemID) continue;
+		if (UseCooldowns.IsCoolingDown(Request.ItemID)) continue;
+
+		UBaseItem* Item = Slot.GetItem();
+		if (!Item) continue;
+
+		// 非消耗品在同一批次内重复使用没有意义，只执行一次
+		if (!Item->bConsumable && DirtySlotMask.IsValidIndex(Request.SlotIndex) && DirtySlotMask[Request.SlotIndex]) continue;
+
+		Item->OnItemUse.Broadcast(User);
+
+		// 委托回调可能修改了库存，重新校验槽位
+		if (!Slots.IsValidIndex(Request.SlotIndex) || Slots[Request.SlotIndex].ItemID != Request.ItemID) continue;
+		FInventorySlot& UsedSlot = Slots[Request.SlotIndex];
+
+		if (Item->bConsumable && --UsedSlot.Quantity <= 0)
+		{
+			TrackedItemBytes -= EstimateSlotBytes(UsedSlot);
+			UsedSlot.Clear();
+		}
+
+		if (Item->UseCooldown > 0.0f)
+			UseCooldowns.Start(Request.ItemID, Item->UseCooldown);
+
+		MarkSlotDirty(Request.SlotIndex);
+	}
+
+	PendingUses.Reset();
+	FlushDirtySlots();
+}
+
+#pragma endregion
+
+#pragma region 库存内存函数
+
+FInventoryMemoryUsage UInventoryManager::GetMemoryUsage() const
+{
+	SingularisInventory::TScratchMap<const UClass*, int64> BytesPerClass;
+	SingularisInventory::TScratchSet<const UObject*> CountedIcons;
+	return CollectMemoryUsage(BytesPerClass, CountedIcons);
+}
+
+FInventoryMemoryUsage UInventoryManager::CollectMemoryUsage(
+	SingularisInventory::TScratchMap<const UClass*, int64>& OutBytesPerClass,
+	SingularisInventory::TScratchSet<const UObject*>& InOutCountedIcons
+) const
+{
+	FInventoryMemoryUsage Usage;
+	Usage.ManagerBytes = static_cast<int64>(const_cast<UInventoryManager*>(this)->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+
+	// 同一个物品实例可能出现在多个槽位，只统计一次；紧凑存储的槽位共享注册表中的定义，不计入物品字节数
+	SingularisInventory::TScratchSet<const UBaseItem*, 64> CountedItems;
+	for (const FInventorySlot& Slot : Slots)
+	{
+		const UBaseItem* Item = Slot.GetItem();
+		if (!Item || CountedItems.Contains(Item)) continue;
+		CountedItems.Add(Item);
+
+		const int64 ItemBytes = EstimateItemBytes(Slot.Item);
+		Usage.ItemBytes += ItemBytes;
+		OutBytesPerClass.FindOrAdd(Item->GetClass()) += ItemBytes;
+
+		// 图标是软引用，只统计已经加载到内存中的资源
+		const UObject* Icon = Item->IconAsset.Get();
+		if (!Icon || InOutCountedIcons.Contains(Icon)) continue;
+		InOutCountedIcons.Add(Icon);
+		Usage.IconBytes += static_cast<int64>(const_cast<UObject*>(Icon)->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+	}
+
+	if (InventoryWidget)
+		Usage.WidgetBytes = static_cast<int64>(InventoryWidget->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+
+	return Usage;
+}
+
+#pragma endregion
+
+#pragma region 库存搜索函数
+
+void UInventoryManager::SearchItemsAsync(const FString& Query, FOnInventorySearchCompleted OnCompleted)
+{
+	if (!SearchIndex.IsValid())
+		RebuildSearchIndex();
+
+	const uint32 Serial = SearchIndex->BeginQuery();
+	TWeakPtr<FInventorySearchIndex, ESPMode::ThreadSafe> WeakIndex = SearchIndex;
+
+	// 游戏线程只负责投递任务，规范化、求交与比较全部在工作线程完成
+	Async(EAsyncExecution::ThreadPool, [WeakIndex, Query, Serial, OnCompleted = MoveTemp(OnCompleted)]() mutable
+	{
+		const TSharedPtr<FInventorySearchIndex, ESPMode::ThreadSafe> Index = WeakIndex.Pin();
+		if (!Index.IsValid() || !Index->IsLatestQuery(Serial)) return;
+
+		TArray<int32> Result = Index->Query(Query);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakIndex, Serial, Result = MoveTemp(Result), OnCompleted = MoveTemp(OnCompleted)]()
+		{
+			// 期间若有新的搜索，旧结果直接丢弃
+			const TSharedPtr<FInventorySearchIndex, ESPMode::ThreadSafe> Index = WeakIndex.Pin();
+			if (Index.IsValid() && Index->IsLatestQuery(Serial))
+				OnCompleted.ExecuteIfBound(Result);
+		});
+	});
+}
+
+void UInventoryManager::RebuildSearchIndex()
+{
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	if (!SearchIndex.IsValid())
+		SearchIndex = MakeShared<FInventorySearchIndex, ESPMode::ThreadSafe>();
+
+	SearchIndex->Reset(Slots.Num());
+	for (int32 i = 0; i < Slots.Num(); ++i)
+		SearchIndex->UpdateSlot(i, Slots[i].GetItem());
+}
+
+TFuture<TArray<int32>> UInventoryManager::SearchItems(const FString& Query) const
+{
+	if (!SearchIndex.IsValid())
+		return MakeFulfilledPromise<TArray<int32>>().GetFuture();
+
+	TSharedPtr<FInventorySearchIndex, ESPMode::ThreadSafe> Index = SearchIndex;
+	return Async(EAsyncExecution::ThreadPool, [Index, Query]()
+	{
+		return Index->Query(Query);
+	});
+}
+
+#pragma endregion
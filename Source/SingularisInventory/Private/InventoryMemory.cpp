@@ -0,0 +1,14 @@
+/* =====================================================================
+ * InventoryMemory.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryMemory.h"
+
+DEFINE_STAT(STAT_SingularisInventory_ScratchSpills);
+
+std::atomic<uint64> SingularisInventory::GScratchSpills{0};
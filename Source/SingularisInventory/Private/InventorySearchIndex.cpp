@@ -0,0 +1,149 @@
+/* =====================================================================
+ * InventorySearchIndex.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventorySearchIndex.h"
+
+#include "BaseItem.h"
+
+void FInventorySearchIndex::Reset(const int32 NumSlots)
+{
+	FWriteScopeLock WriteLock(Lock);
+	Names.Reset();
+	Names.SetNum(NumSlots);
+	Grams.Reset();
+}
+
+void FInventorySearchIndex::UpdateSlot(const int32 SlotIndex, const UBaseItem* Item)
+{
+	check(IsInGameThread());
+	if (SlotIndex < 0) return;
+
+	// 名称的规范化在锁外的栈缓冲中完成，写锁只覆盖倒排表的增删
+	TStringBuilder<128> NewName;
+	if (Item)
+		NormalizeInto(Item->DisplayName.ToString(), NewName);
+
+	FWriteScopeLock WriteLock(Lock);
+	if (!Names.IsValidIndex(SlotIndex))
+		Names.SetNum(SlotIndex + 1);
+
+	if (FStringView(Names[SlotIndex]).Equals(NewName.ToView(), ESearchCase::CaseSensitive))
+		return;
+
+	// 复用槽位名称原有的字符串缓冲，稳态下不产生新的堆分配
+	RemoveSlotGrams_Locked(SlotIndex);
+	Names[SlotIndex].Reset(NewName.Len());
+	Names[SlotIndex].Append(NewName.GetData(), NewName.Len());
+	AddSlotGrams_Locked(SlotIndex);
+}
+
+TArray<int32> FInventorySearchIndex::Query(const FString& Text) const
+{
+	TArray<int32> Result;
+	const FString Needle = Normalize(Text);
+	if (Needle.IsEmpty()) return Result;
+
+	FReadScopeLock ReadLock(Lock);
+
+	// 短查询没有完整三元组，直接前缀/子串扫描
+	if (Needle.Len() < 3)
+	{
+		for (int32 i = 0; i < Names.Num(); ++i)
+			if (!Names[i].IsEmpty() && Names[i].Contains(Needle, ESearchCase::CaseSensitive))
+				Result.Add(i);
+		return Result;
+	}
+
+	SingularisInventory::TScratchArray<uint64, 32> NeedleGrams;
+	CollectGrams(Needle, NeedleGrams);
+
+	// 从最短的倒排表开始求交集
+	const TArray<int32>* Smallest = nullptr;
+	for (const uint64 Gram : NeedleGrams)
+	{
+		const TArray<int32>* Postings = Grams.Find(Gram);
+		if (!Postings) return Result;
+		if (!Smallest || Postings->Num() < Smallest->Num())
+			Smallest = Postings;
+	}
+
+	// 三元组只做候选过滤，最终以子串比较确认
+	for (const int32 SlotIndex : *Smallest)
+		if (Names[SlotIndex].Contains(Needle, ESearchCase::CaseSensitive))
+			Result.Add(SlotIndex);
+
+	Result.Sort();
+	return Result;
+}
+
+SIZE_T FInventorySearchIndex::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+	SIZE_T Size = Names.GetAllocatedSize() + Grams.GetAllocatedSize();
+	for (const FString& Name : Names)
+		Size += Name.GetAllocatedSize();
+	for (const TPair<uint64, TArray<int32>>& Pair : Grams)
+		Size += Pair.Value.GetAllocatedSize();
+	return Size;
+}
+
+FString FInventorySearchIndex::Normalize(const FString& Name)
+{
+	TStringBuilder<128> Builder;
+	NormalizeInto(Name, Builder);
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+void FInventorySearchIndex::NormalizeInto(const FStringView Name, FStringBuilderBase& Out)
+{
+	const FStringView Trimmed = Name.TrimStartAndEnd();
+	const int32 Start = Out.Len();
+	Out.Append(Trimmed);
+
+	TCHAR* Chars = Out.GetData();
+	for (int32 i = Start; i < Out.Len(); ++i)
+		Chars[i] = FChar::ToLower(Chars[i]);
+}
+
+uint64 FInventorySearchIndex::MakeGramKey(const TCHAR A, const TCHAR B, const TCHAR C)
+{
+	// 每个字符占 21 位，足以覆盖全部 Unicode 码点
+	constexpr uint64 Mask = (1ull << 21) - 1;
+	return ((static_cast<uint64>(A) & Mask) << 42) | ((static_cast<uint64>(B) & Mask) << 21) | (static_cast<uint64>(C) & Mask);
+}
+
+void FInventorySearchIndex::CollectGrams(const FString& Name, SingularisInventory::TScratchArray<uint64, 32>& OutGrams)
+{
+	const TCHAR* Chars = *Name;
+	for (int32 i = 0; i + 2 < Name.Len(); ++i)
+		OutGrams.AddUnique(MakeGramKey(Chars[i], Chars[i + 1], Chars[i + 2]));
+}
+
+void FInventorySearchIndex::RemoveSlotGrams_Locked(const int32 SlotIndex)
+{
+	SingularisInventory::TScratchArray<uint64, 32> SlotGrams;
+	CollectGrams(Names[SlotIndex], SlotGrams);
+
+	for (const uint64 Gram : SlotGrams)
+		if (TArray<int32>* Postings = Grams.Find(Gram))
+		{
+			Postings->RemoveSingleSwap(SlotIndex, EAllowShrinking::No);
+			if (Postings->IsEmpty())
+				Grams.Remove(Gram);
+		}
+}
+
+void FInventorySearchIndex::AddSlotGrams_Locked(const int32 SlotIndex)
+{
+	SingularisInventory::TScratchArray<uint64, 32> SlotGrams;
+	CollectGrams(Names[SlotIndex], SlotGrams);
+
+	for (const uint64 Gram : SlotGrams)
+		Grams.FindOrAdd(Gram).Add(SlotIndex);
+}
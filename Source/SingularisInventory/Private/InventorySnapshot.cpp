@@ -0,0 +1,95 @@
+/* =====================================================================
+ * InventorySnapshot.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventorySnapshot.h"
+
+#include "BaseItem.h"
+#include "InventoryManager.h"
+#include "SingularisInventory.h"
+
+double FInventorySnapshot::GetTotalValue() const
+{
+	double Total = 0.0;
+	for (const TSharedRef<const FChunk, ESPMode::ThreadSafe>& Chunk : Chunks)
+		Total += Chunk->TotalValue;
+	return Total;
+}
+
+FInventorySnapshotPublisher::FInventorySnapshotPublisher()
+	: Latest(MakeShared<const FInventorySnapshot, ESPMode::ThreadSafe>())
+{
+}
+
+void FInventorySnapshotPublisher::MarkDirty(const int32 SlotIndex)
+{
+	const int32 ChunkIndex = SlotIndex / FInventorySnapshot::SlotsPerChunk;
+	if (DirtyChunks.Num() <= ChunkIndex)
+		DirtyChunks.SetNum(ChunkIndex + 1, false);
+
+	DirtyChunks[ChunkIndex] = true;
+	bHasPendingChanges = true;
+}
+
+void FInventorySnapshotPublisher::Publish(const TConstArrayView<FInventorySlot> Slots)
+{
+	check(IsInGameThread());
+	if (!bHasPendingChanges) return;
+
+	LLM_SCOPE_BYTAG(SingularisInventory);
+
+	// 发布只发生在游戏线程，读取旧快照不需要加锁
+	const FInventorySnapshot& Previous = *Latest;
+	const int32 NumChunks = FMath::DivideAndRoundUp(Slots.Num(), FInventorySnapshot::SlotsPerChunk);
+
+	TSharedRef<FInventorySnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FInventorySnapshot, ESPMode::ThreadSafe>();
+	Snapshot->NumSlots = Slots.Num();
+	Snapshot->Version = Previous.Version + 1;
+	Snapshot->Chunks.Reserve(NumChunks);
+
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+	{
+		const bool bDirty = DirtyChunks.IsValidIndex(ChunkIndex) && DirtyChunks[ChunkIndex];
+		const bool bSameLayout = Previous.NumSlots == Slots.Num();
+		if (!bDirty && bSameLayout && Previous.Chunks.IsValidIndex(ChunkIndex))
+		{
+			Snapshot->Chunks.Add(Previous.Chunks[ChunkIndex]);
+			continue;
+		}
+
+		// 变化的块整体复制，旧快照的读者继续看到旧块
+		TSharedRef<FInventorySnapshot::FChunk, ESPMode::ThreadSafe> Chunk = MakeShared<FInventorySnapshot::FChunk, ESPMode::ThreadSafe>();
+		const int32 Begin = ChunkIndex * FInventorySnapshot::SlotsPerChunk;
+		const int32 End = FMath::Min(Begin + FInventorySnapshot::SlotsPerChunk, Slots.Num());
+		for (int32 SlotIndex = Begin; SlotIndex < End; ++SlotIndex)
+		{
+			const FInventorySlot& Slot = Slots[SlotIndex];
+			if (Slot.bIsEmpty) continue;
+
+			FInventorySnapshotSlot& Entry = Chunk->Slots[SlotIndex - Begin];
+			const UBaseItem* Item = Slot.GetItem();
+			Entry.ItemID = Slot.ItemID;
+			Entry.Quantity = Slot.Quantity;
+			Entry.Value = Item ? Item->ItemValue : 0.0f;
+			Chunk->TotalValue += static_cast<double>(Entry.Value) * Entry.Quantity;
+		}
+		Snapshot->Chunks.Add(Chunk);
+	}
+
+	DirtyChunks.Init(false, NumChunks);
+	bHasPendingChanges = false;
+
+	FWriteScopeLock Lock(LatestLock);
+	Latest = Snapshot;
+}
+
+TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> FInventorySnapshotPublisher::GetLatest() const
+{
+	FReadScopeLock Lock(LatestLock);
+	return Latest;
+}
@@ -0,0 +1,74 @@
+/* =====================================================================
+ * InventoryStressCommandlet.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryStressCommandlet.h"
+
+#include "InventoryStressTest.h"
+#include "Misc/Parse.h"
+
+UInventoryStressCommandlet::UInventoryStressCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UInventoryStressCommandlet::Main(const FString& Params)
+{
+	FString Mode;
+	if (FParse::Value(*Params, TEXT("Mode="), Mode) && Mode.Equals(TEXT("Spatial"), ESearchCase::IgnoreCase))
+	{
+		FItemSpatialBenchmarkParams SpatialParams;
+		SpatialParams.Parse(*Params);
+
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("世界物品空间查询基准: 物品 %d 个, 玩家 %d 个, %d 帧, 每帧重新掉落 %d 个"),
+			SpatialParams.NumItems,
+			SpatialParams.NumPlayers,
+			SpatialParams.NumFrames,
+			SpatialParams.ChurnPerFrame
+		);
+
+		const FItemSpatialBenchmarkResult Result = SingularisInventory::RunSpatialBenchmark(SpatialParams);
+		UE_LOG(LogTemp, Display, TEXT("世界物品空间查询基准结果: %s"), *Result.ToString());
+		return Result.bResultsMatch ? 0 : 1;
+	}
+
+	FInventoryStressParams StressParams;
+	StressParams.Parse(*Params);
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("库存压力测试: 库存 %d 个, 每个 %d 槽位, 操作 %d 次, GC 间隔 %d, 种子 %d, %s%s"),
+		StressParams.NumInventories,
+		StressParams.SlotsPerInventory,
+		StressParams.NumOperations,
+		StressParams.GCInterval,
+		StressParams.Seed,
+		StressParams.bCompareStorage ? TEXT("对比两种存储") : StressParams.bCompactStorage ? TEXT("紧凑存储") : TEXT("实例存储"),
+		StressParams.bPrefill ? TEXT(", 预先填满") : TEXT("")
+	);
+
+	if (StressParams.bCompareStorage)
+	{
+		const TPair<FInventoryStressResult, FInventoryStressResult> Results = SingularisInventory::RunStorageComparison(StressParams);
+		UE_LOG(LogTemp, Display, TEXT("库存压力测试存储方式对比:\n%s"), *SingularisInventory::DescribeStorageComparison(Results));
+		return 0;
+	}
+
+	const FInventoryStressResult Result = SingularisInventory::RunStressTest(StressParams);
+	UE_LOG(LogTemp, Display, TEXT("库存压力测试结果: %s"), *Result.ToString());
+
+	return 0;
+}
@@ -0,0 +1,413 @@
+/* =====================================================================
+ * InventoryStressTest.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryStressTest.h"
+
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+#include "ItemSpatialHash.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/Package.h"
+
+void FInventoryStressParams::Parse(const TCHAR* Params)
+{
+	FParse::Value(Params, TEXT("Inventories="), NumInventories);
+	FParse::Value(Params, TEXT("Slots="), SlotsPerInventory);
+	FParse::Value(Params, TEXT("Ops="), NumOperations);
+	FParse::Value(Params, TEXT("GCInterval="), GCInterval);
+	FParse::Value(Params, TEXT("Seed="), Seed);
+	FParse::Value(Params, TEXT("MeasureGC="), MeasuredGCRuns);
+	bCompactStorage = bCompactStorage || FParse::Param(Params, TEXT("Compact"));
+	bPrefill = bPrefill || FParse::Param(Params, TEXT("Prefill"));
+	bCompareStorage = bCompareStorage || FParse::Param(Params, TEXT("CompareStorage"));
+
+	NumInventories = FMath::Max(NumInventories, 1);
+	SlotsPerInventory = FMath::Max(SlotsPerInventory, 1);
+	NumOperations = FMath::Max(NumOperations, 0);
+	GCInterval = FMath::Max(GCInterval, 0);
+	MeasuredGCRuns = FMath::Max(MeasuredGCRuns, 0);
+}
+
+FString FInventoryStressResult::ToString() const
+{
+	FString Result = FString::Printf(
+		TEXT("操作 %lld 次, 耗时 %.3f 秒, %.0f ops/s, p50 %.2f us, p99 %.2f us, 最大 %.2f us, GC %d 次共 %.2f ms, 存放物品 %lld 个"),
+		NumOperations,
+		TotalSeconds,
+		OpsPerSecond,
+		P50Microseconds,
+		P99Microseconds,
+		MaxMicroseconds,
+		NumGCRuns,
+		GCMilliseconds,
+		NumStoredItems
+	);
+
+	if (NumMeasuredGCRuns > 0)
+		Result += FString::Printf(TEXT(", 稳态 GC %d 次平均 %.2f ms"), NumMeasuredGCRuns, MeasuredGCAverageMilliseconds);
+
+	return Result;
+}
+
+void FItemSpatialBenchmarkParams::Parse(const TCHAR* Params)
+{
+	FParse::Value(Params, TEXT("Items="), NumItems);
+	FParse::Value(Params, TEXT("Players="), NumPlayers);
+	FParse::Value(Params, TEXT("Frames="), NumFrames);
+	FParse::Value(Params, TEXT("Churn="), ChurnPerFrame);
+	FParse::Value(Params, TEXT("WorldSize="), WorldSize);
+	FParse::Value(Params, TEXT("Radius="), PickupRadius);
+	FParse::Value(Params, TEXT("CellSize="), CellSize);
+	FParse::Value(Params, TEXT("Seed="), Seed);
+
+	NumItems = FMath::Max(NumItems, 1);
+	NumPlayers = FMath::Max(NumPlayers, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+	ChurnPerFrame = FMath::Clamp(ChurnPerFrame, 0, NumItems);
+	WorldSize = FMath::Max(WorldSize, 1.0f);
+	PickupRadius = FMath::Max(PickupRadius, 0.0f);
+	CellSize = FMath::Max(CellSize, 1.0f);
+}
+
+FString FItemSpatialBenchmarkResult::ToString() const
+{
+	return FString::Printf(
+		TEXT("空间哈希 %.2f us/帧, 逐个遍历 %.2f us/帧, 加速 %.1fx, 平均命中 %.2f, 结果%s"),
+		HashMicrosecondsPerFrame,
+		BruteForceMicrosecondsPerFrame,
+		HashMicrosecondsPerFrame > 0.0 ? BruteForceMicrosecondsPerFrame / HashMicrosecondsPerFrame : 0.0,
+		AverageHitsPerQuery,
+		bResultsMatch ? TEXT("一致") : TEXT("不一致")
+	);
+}
+
+namespace
+{
+	enum class EStressOp : uint8
+	{
+		Add,
+		Remove,
+		Swap,
+		Select
+	};
+
+	/** 操作比例：添加 40%，删除 30%，交换 20%，选中 10% */
+	EStressOp PickOperation(const FRandomStream& Random)
+	{
+		const int32 Roll = Random.RandRange(0, 99);
+		if (Roll < 40) return EStressOp::Add;
+		if (Roll < 70) return EStressOp::Remove;
+		if (Roll < 90) return EStressOp::Swap;
+		return EStressOp::Select;
+	}
+
+	/**
+	 * 压力测试物品使用的保留 ItemID 区间起点
+	 *
+	 * 注册表是进程级的，测试物品放在游戏不会使用的高位区间，
+	 * 结束时再注销，避免覆盖或残留在正常物品的 ID 上。
+	 */
+	constexpr int32 StressItemIDBase = MAX_int32 - 0xFFFF;
+
+	double CyclesToMicroseconds(const uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles) * 1000.0;
+	}
+}
+
+FInventoryStressResult SingularisInventory::RunStressTest(const FInventoryStressParams& Params)
+{
+	check(IsInGameThread());
+
+	FInventoryStressResult Result;
+	FRandomStream Random(Params.Seed);
+
+	// 少量名称循环使用，让搜索索引的倒排表保持真实的重复度
+	static const TCHAR* ItemNames[] = {
+		TEXT("Health Potion"), TEXT("Mana Potion"), TEXT("Iron Sword"), TEXT("Wooden Shield"),
+		TEXT("Gold Coin"), TEXT("Silver Ring"), TEXT("Arrow"), TEXT("Bread")
+	};
+
+	constexpr int32 NumItemNames = UE_ARRAY_COUNT(ItemNames);
+
+	// 紧凑存储通过 ItemID 添加，每种物品只注册一个共享定义
+	UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+	bool bCompact = Params.bCompactStorage && Registry;
+	if (Params.bCompactStorage && !Registry)
+		UE_LOG(LogTemp, Warning, TEXT("物品注册表不可用，压力测试退回实例存储"));
+
+	TArray<UInventoryStressItem*, TInlineAllocator<NumItemNames>> Definitions;
+	if (bCompact)
+	{
+		for (int32 i = 0; i < NumItemNames; ++i)
+		{
+			UInventoryStressItem* Definition = NewObject<UInventoryStressItem>(GetTransientPackage());
+			Definition->ItemID = StressItemIDBase + i;
+			Definition->DisplayName = FText::FromString(ItemNames[i]);
+			if (!Registry->RegisterItemDefinition(Definition->ItemID, Definition)
+				|| Registry->FindItemDefinition(Definition->ItemID) != Definition)
+				break;
+
+			Definition->AddToRoot();
+			Definitions.Add(Definition);
+		}
+
+		// 保留区间已被占用时不覆盖已有定义，退回实例存储
+		if (Definitions.Num() != NumItemNames)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("压力测试保留的物品ID已被占用，退回实例存储"));
+			bCompact = false;
+		}
+	}
+
+	auto MakeItem = [&Random]()
+	{
+		const int32 NameIndex = Random.RandRange(0, NumItemNames - 1);
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>(GetTransientPackage());
+		Item->ItemID = StressItemIDBase + NameIndex;
+		Item->DisplayName = FText::FromString(ItemNames[NameIndex]);
+		return Item;
+	};
+
+	TArray<UInventoryManager*> Managers;
+	Managers.Reserve(Params.NumInventories);
+	for (int32 i = 0; i < Params.NumInventories; ++i)
+	{
+		UInventoryManager* Manager = NewObject<UInventoryManager>(GetTransientPackage());
+		Manager->AddToRoot();
+		Manager->ItemStorage = bCompact ? EInventoryItemStorage::Compact : EInventoryItemStorage::Instanced;
+		Manager->Slots.SetNum(Params.SlotsPerInventory);
+		Manager->RebuildSearchIndex();
+		Managers.Add(Manager);
+
+		if (Params.bPrefill)
+			for (int32 Slot = 0; Slot < Params.SlotsPerInventory; ++Slot)
+			{
+				if (bCompact)
+					Manager->TryAddItemByID(StressItemIDBase + Random.RandRange(0, NumItemNames - 1));
+				else
+					Manager->TryAddItem(MakeItem());
+			}
+	}
+
+	TArray<uint64> Samples;
+	Samples.Reserve(Params.NumOperations);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	uint64 GCCycles = 0;
+
+	for (int32 Op = 0; Op < Params.NumOperations; ++Op)
+	{
+		UInventoryManager* Manager = Managers[Random.RandRange(0, Managers.Num() - 1)];
+		const int32 SlotA = Random.RandRange(0, Params.SlotsPerInventory - 1);
+		const int32 SlotB = Random.RandRange(0, Params.SlotsPerInventory - 1);
+		const EStressOp Operation = PickOperation(Random);
+
+		// 物品对象在计时之外创建，只测量库存本身的开销
+		UInventoryStressItem* NewItem = nullptr;
+		int32 NewItemID = INDEX_NONE;
+		if (Operation == EStressOp::Add)
+		{
+			if (bCompact)
+				NewItemID = StressItemIDBase + Random.RandRange(0, NumItemNames - 1);
+			else
+				NewItem = MakeItem();
+		}
+
+		const uint64 OpStart = FPlatformTime::Cycles64();
+		switch (Operation)
+		{
+		case EStressOp::Add:
+			if (bCompact)
+				Manager->TryAddItemByID(NewItemID);
+			else
+				Manager->TryAddItem(NewItem);
+			break;
+		case EStressOp::Remove:
+			Manager->RemoveItemByIndex(SlotA);
+			break;
+		case EStressOp::Swap:
+			Manager->SwapSlots(SlotA, SlotB);
+			break;
+		case EStressOp::Select:
+			Manager->SetSlotSelect(SlotA);
+			break;
+		}
+		Samples.Add(FPlatformTime::Cycles64() - OpStart);
+
+		if (Params.GCInterval > 0 && (Op + 1) % Params.GCInterval == 0)
+		{
+			const uint64 GCStart = FPlatformTime::Cycles64();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			GCCycles += FPlatformTime::Cycles64() - GCStart;
+			++Result.NumGCRuns;
+		}
+	}
+
+	Result.TotalSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+	Result.NumOperations = Samples.Num();
+	Result.OpsPerSecond = Result.TotalSeconds > 0.0 ? Result.NumOperations / Result.TotalSeconds : 0.0;
+	Result.GCMilliseconds = FPlatformTime::ToMilliseconds64(GCCycles);
+
+	if (Samples.Num() > 0)
+	{
+		Samples.Sort();
+		Result.P50Microseconds = CyclesToMicroseconds(Samples[Samples.Num() / 2]);
+		Result.P99Microseconds = CyclesToMicroseconds(Samples[FMath::Min(Samples.Num() * 99 / 100, Samples.Num() - 1)]);
+		Result.MaxMicroseconds = CyclesToMicroseconds(Samples.Last());
+	}
+
+	for (const UInventoryManager* Manager : Managers)
+		for (const FInventorySlot& Slot : Manager->Slots)
+			Result.NumStoredItems += Slot.bIsEmpty ? 0 : 1;
+
+	if (Params.MeasuredGCRuns > 0)
+	{
+		// 先做一次完整 GC 清掉操作期间产生的垃圾，之后的耗时主要来自可达性分析
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		const uint64 GCStart = FPlatformTime::Cycles64();
+		for (int32 i = 0; i < Params.MeasuredGCRuns; ++i)
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		Result.NumMeasuredGCRuns = Params.MeasuredGCRuns;
+		Result.MeasuredGCAverageMilliseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - GCStart) / Params.MeasuredGCRuns;
+	}
+
+	for (UInventoryManager* Manager : Managers)
+		Manager->RemoveFromRoot();
+
+	// 注销本次注册的测试定义，注册表回到测试前的状态
+	for (UInventoryStressItem* Definition : Definitions)
+	{
+		if (Registry)
+			Registry->UnregisterItemDefinition(Definition->ItemID, Definition);
+		Definition->RemoveFromRoot();
+	}
+
+	return Result;
+}
+
+TPair<FInventoryStressResult, FInventoryStressResult> SingularisInventory::RunStorageComparison(FInventoryStressParams Params)
+{
+	// 两次运行使用相同的种子，物品数量与操作序列一致；紧凑存储运行前的预热 GC 会回收上一次留下的物品
+	Params.bCompactStorage = false;
+	const FInventoryStressResult Instanced = RunStressTest(Params);
+
+	Params.bCompactStorage = true;
+	const FInventoryStressResult Compact = RunStressTest(Params);
+
+	return {Instanced, Compact};
+}
+
+FString SingularisInventory::DescribeStorageComparison(const TPair<FInventoryStressResult, FInventoryStressResult>& Results)
+{
+	const FInventoryStressResult& Instanced = Results.Key;
+	const FInventoryStressResult& Compact = Results.Value;
+
+	FString Description = FString::Printf(TEXT("实例存储: %s\n紧凑存储: %s"), *Instanced.ToString(), *Compact.ToString());
+	if (Instanced.NumMeasuredGCRuns > 0 && Compact.NumMeasuredGCRuns > 0 && Instanced.MeasuredGCAverageMilliseconds > 0.0)
+	{
+		Description += FString::Printf(
+			TEXT("\n稳态 GC 平均耗时 %.2f ms -> %.2f ms（%.1f%%）"),
+			Instanced.MeasuredGCAverageMilliseconds,
+			Compact.MeasuredGCAverageMilliseconds,
+			100.0 * Compact.MeasuredGCAverageMilliseconds / Instanced.MeasuredGCAverageMilliseconds
+		);
+	}
+	return Description;
+}
+
+FItemSpatialBenchmarkResult SingularisInventory::RunSpatialBenchmark(const FItemSpatialBenchmarkParams& Params)
+{
+	FItemSpatialBenchmarkResult Result;
+	FRandomStream Random(Params.Seed);
+
+	auto RandomLocation = [&Random, &Params]()
+	{
+		return FVector(Random.FRandRange(0.0f, Params.WorldSize), Random.FRandRange(0.0f, Params.WorldSize), Random.FRandRange(0.0f, 200.0f));
+	};
+
+	FItemSpatialHash SpatialHash(Params.CellSize);
+	TArray<int32> Handles;
+	TArray<FVector> Locations;
+	Handles.Reserve(Params.NumItems);
+	Locations.Reserve(Params.NumItems);
+	for (int32 i = 0; i < Params.NumItems; ++i)
+	{
+		Locations.Add(RandomLocation());
+		Handles.Add(SpatialHash.Add(Locations.Last()));
+	}
+
+	TArray<FVector> Players;
+	Players.SetNum(Params.NumPlayers);
+
+	const float RadiusSquared = Params.PickupRadius * Params.PickupRadius;
+	uint64 HashCycles = 0;
+	uint64 BruteForceCycles = 0;
+	int64 HashHits = 0;
+	int64 BruteForceHits = 0;
+	int64 HashNearestFound = 0;
+	int64 BruteForceNearestFound = 0;
+
+	for (int32 Frame = 0; Frame < Params.NumFrames; ++Frame)
+	{
+		// 模拟拾取与新的掉落
+		for (int32 i = 0; i < Params.ChurnPerFrame; ++i)
+		{
+			const int32 Item = Random.RandRange(0, Params.NumItems - 1);
+			SpatialHash.Remove(Handles[Item]);
+			Locations[Item] = RandomLocation();
+			Handles[Item] = SpatialHash.Add(Locations[Item]);
+		}
+
+		for (FVector& Player : Players)
+			Player = RandomLocation();
+
+		uint64 Start = FPlatformTime::Cycles64();
+		for (const FVector& Player : Players)
+		{
+			SpatialHash.ForEachInRadius(Player, Params.PickupRadius, [&HashHits](int32, float) { ++HashHits; });
+			if (SpatialHash.FindNearest(Player, Params.PickupRadius) != INDEX_NONE)
+				++HashNearestFound;
+		}
+		HashCycles += FPlatformTime::Cycles64() - Start;
+
+		Start = FPlatformTime::Cycles64();
+		for (const FVector& Player : Players)
+		{
+			float BestDistanceSquared = RadiusSquared;
+			int32 BestItem = INDEX_NONE;
+			for (int32 Item = 0; Item < Locations.Num(); ++Item)
+			{
+				const float DistanceSquared = FVector::DistSquared(Locations[Item], Player);
+				if (DistanceSquared > RadiusSquared) continue;
+
+				++BruteForceHits;
+				if (DistanceSquared <= BestDistanceSquared)
+				{
+					BestDistanceSquared = DistanceSquared;
+					BestItem = Item;
+				}
+			}
+
+			if (BestItem != INDEX_NONE)
+				++BruteForceNearestFound;
+		}
+		BruteForceCycles += FPlatformTime::Cycles64() - Start;
+	}
+
+	Result.HashMicrosecondsPerFrame = CyclesToMicroseconds(HashCycles) / Params.NumFrames;
+	Result.BruteForceMicrosecondsPerFrame = CyclesToMicroseconds(BruteForceCycles) / Params.NumFrames;
+	Result.AverageHitsPerQuery = static_cast<double>(HashHits) / (static_cast<double>(Params.NumFrames) * Params.NumPlayers);
+	Result.bResultsMatch = HashHits == BruteForceHits && HashNearestFound == BruteForceNearestFound;
+	return Result;
+}
@@ -9,6 +9,9 @@
 
 #include "InventoryWidget.h"
 
+#include "InventoryGridWidget.h"
+#include "Blueprint/WidgetTree.h"
+
 void UInventoryWidget::ShowWidget()
 {
 	SetVisibility(ESlateVisibility::Visible);
@@ -18,3 +21,14 @@ void UInventoryWidget::HideWidget()
 {
 	SetVisibility(ESlateVisibility::Hidden);
 }
+
+void UInventoryWidget::BindInventory(UInventoryManager* Inventory)
+{
+	if (!WidgetTree) return;
+
+	WidgetTree->ForEachWidget([Inventory](UWidget* Widget)
+	{
+		if (UInventoryGridWidget* Grid = Cast<UInventoryGridWidget>(Widget))
+			Grid->SetInventory(Inventory);
+	});
+}
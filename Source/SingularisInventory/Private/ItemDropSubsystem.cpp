@@ -0,0 +1,261 @@
+/* =====================================================================
+ * ItemDropSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "ItemDropSubsystem.h"
+
+#include "BaseItem.h"
+#include "BaseItemActor.h"
+#include "InventoryMemory.h"
+#include "SingularisInventory.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarItemDropPromotionRadius(
+	TEXT("SI.DropPromotionRadius"),
+	400.0f,
+	TEXT("玩家进入该半径（厘米）后，实例化渲染的掉落物品会被提升为完整的物品表现 Actor，0 表示只在交互时提升"),
+	ECVF_Default
+);
+
+void UItemDropSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	SpatialHash = FItemSpatialHash();
+}
+
+void UItemDropSubsystem::Deinitialize()
+{
+	if (HostActor)
+		HostActor->Destroy();
+	HostActor = nullptr;
+
+	Batches.Reset();
+	Drops.Reset();
+	ClassToBatch.Reset();
+	KeyToDrop.Reset();
+	SpatialHash = FItemSpatialHash();
+
+	Super::Deinitialize();
+}
+
+bool UItemDropSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UItemDropSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemDropSubsystem, STATGROUP_SingularisInventory);
+}
+
+void UItemDropSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float PromotionRadius = CVarItemDropPromotionRadius.GetValueOnGameThread();
+	if (PromotionRadius > 0.0f && SpatialHash.Num() > 0)
+	{
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* Controller = It->Get();
+			if (const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr)
+				PromoteDropsNear(Pawn->GetActorLocation(), PromotionRadius, nullptr);
+		}
+	}
+
+	// 每帧最多提交一次实例变换，多次增删合并为一次渲染状态更新
+	for (FItemDropBatch& Batch : Batches)
+		if (Batch.bRenderStateDirty && Batch.Component)
+		{
+			Batch.Component->MarkRenderStateDirty();
+			Batch.bRenderStateDirty = false;
+		}
+}
+
+ABaseItemActor* UItemDropSubsystem::DropItem(UBaseItem* Item, const FTransform Transform)
+{
+	if (!Item || !Item->VisualActorClass) return nullptr;
+
+	const int32 BatchIndex = FindOrAddBatch(Item->VisualActorClass);
+	if (BatchIndex == INDEX_NONE)
+		return SpawnItemActor(Item, Transform);
+
+	FItemDropBatch& Batch = Batches[BatchIndex];
+	const int32 DropHandle = SpatialHash.Add(Transform.GetLocation());
+	if (!Drops.IsValidIndex(DropHandle))
+		Drops.SetNum(DropHandle + 1);
+
+	// 实例始终追加在末尾，移除时由最后一个实例填补，索引保持连续
+	const int32 InstanceIndex = Batch.Component->AddInstance(Transform, true);
+	check(InstanceIndex == Batch.InstanceToDrop.Num());
+	Batch.InstanceToDrop.Add(DropHandle);
+	Batch.bRenderStateDirty = true;
+
+	FItemDrop& Drop = Drops[DropHandle];
+	Drop.Item = Item;
+	Drop.Transform = Transform;
+	Drop.BatchIndex = BatchIndex;
+	Drop.InstanceIndex = InstanceIndex;
+	Drop.DropKey = MakeDropKey(Item->ItemID, Transform.GetLocation());
+	KeyToDrop.Add(Drop.DropKey, DropHandle);
+	return nullptr;
+}
+
+void UItemDropSubsystem::PromoteDropsInRadius(const FVector Location, const float Radius, TArray<ABaseItemActor*>& OutActors)
+{
+	OutActors.Reset();
+	PromoteDropsNear(Location, Radius, &OutActors);
+}
+
+void UItemDropSubsystem::PromoteDropsNear(const FVector& Location, const float Radius, TArray<ABaseItemActor*>* OutActors)
+{
+	// 先收集再提升，避免遍历过程中修改空间哈希；半径内的数量没有上限，分配在内存栈上
+	SingularisInventory::FInventoryScratchScope ScratchScope;
+	SingularisInventory::TArenaArray<int32> Handles;
+	SpatialHash.ForEachInRadius(Location, Radius, [&Handles](const int32 Handle, float)
+	{
+		Handles.Add(Handle);
+	});
+
+	for (const int32 Handle : Handles)
+		if (ABaseItemActor* ItemActor = PromoteDrop(Handle); ItemActor && OutActors)
+			OutActors->Add(ItemActor);
+}
+
+int32 UItemDropSubsystem::FindOrAddBatch(const TSubclassOf<ABaseItemActor> VisualClass)
+{
+	if (const int32* Existing = ClassToBatch.Find(VisualClass.Get()))
+		return *Existing;
+
+	UStaticMesh* Mesh = VisualClass->GetDefaultObject<ABaseItemActor>()->InstancedDropMesh;
+	if (!Mesh)
+	{
+		ClassToBatch.Add(VisualClass.Get(), INDEX_NONE);
+		return INDEX_NONE;
+	}
+
+	if (!HostActor)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = TEXT("ItemDropHost");
+		SpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		SpawnParameters.ObjectFlags = RF_Transient;
+		HostActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		HostActor->SetRootComponent(NewObject<USceneComponent>(HostActor, TEXT("Root")));
+		HostActor->GetRootComponent()->RegisterComponent();
+	}
+
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(HostActor, NAME_None, RF_Transient);
+	Component->SetStaticMesh(Mesh);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCanEverAffectNavigation(false);
+	Component->SetupAttachment(HostActor->GetRootComponent());
+	Component->RegisterComponent();
+
+	FItemDropBatch& Batch = Batches.AddDefaulted_GetRef();
+	Batch.Component = Component;
+	Batch.VisualClass = VisualClass;
+
+	const int32 BatchIndex = Batches.Num() - 1;
+	ClassToBatch.Add(VisualClass.Get(), BatchIndex);
+	return BatchIndex;
+}
+
+ABaseItemActor* UItemDropSubsystem::PromoteDrop(const int32 DropHandle)
+{
+	if (!SpatialHash.IsValidHandle(DropHandle)) return nullptr;
+
+	// 客户端不生成会复制的 Actor，否则会与服务器复制过来的 Actor 重复
+	const FItemDrop& Drop = Drops[DropHandle];
+	if (!CanPromoteBatch(Batches[Drop.BatchIndex])) return nullptr;
+
+	UBaseItem* Item = Drop.Item;
+	const FTransform Transform = Drop.Transform;
+	const uint32 DropKey = Drop.DropKey;
+	RemoveDropInstance(DropHandle);
+
+	return SpawnItemActor(Item, Transform, DropKey);
+}
+
+bool UItemDropSubsystem::CanPromoteBatch(const FItemDropBatch& Batch) const
+{
+	if (GetWorld()->GetNetMode() != NM_Client) return true;
+	return !Batch.VisualClass || !Batch.VisualClass->GetDefaultObject<ABaseItemActor>()->GetIsReplicated();
+}
+
+void UItemDropSubsystem::RemoveDropInstance(const int32 DropHandle)
+{
+	FItemDrop& Drop = Drops[DropHandle];
+	FItemDropBatch& Batch = Batches[Drop.BatchIndex];
+
+	// 把最后一个实例移入空出的索引再移除末尾，其余实例的索引不变，组件中不残留空闲实例
+	const int32 LastIndex = Batch.InstanceToDrop.Num() - 1;
+	if (Drop.InstanceIndex != LastIndex)
+	{
+		const int32 MovedHandle = Batch.InstanceToDrop[LastIndex];
+		Batch.Component->UpdateInstanceTransform(Drop.InstanceIndex, Drops[MovedHandle].Transform, true, false, true);
+		Batch.InstanceToDrop[Drop.InstanceIndex] = MovedHandle;
+		Drops[MovedHandle].InstanceIndex = Drop.InstanceIndex;
+	}
+	Batch.Component->RemoveInstance(LastIndex);
+	Batch.InstanceToDrop.Pop(EAllowShrinking::No);
+	Batch.bRenderStateDirty = true;
+
+	KeyToDrop.RemoveSingle(Drop.DropKey, DropHandle);
+	SpatialHash.Remove(DropHandle);
+	Drop = FItemDrop();
+}
+
+void UItemDropSubsystem::ReleaseReplicatedDrop(const ABaseItemActor* ItemActor)
+{
+	if (!ItemActor || ItemActor->DropKey == 0 || SpatialHash.Num() == 0) return;
+
+	const int32* BatchIndex = ClassToBatch.Find(ItemActor->GetClass());
+	if (!BatchIndex || *BatchIndex == INDEX_NONE) return;
+
+	// 标识相同的同类掉落就是服务器提升的那一个；标识重复时它们是同一位置的同种物品，移除任意一个结果相同
+	int32 MatchedHandle = INDEX_NONE;
+	for (auto It = KeyToDrop.CreateConstKeyIterator(ItemActor->DropKey); It; ++It)
+		if (Drops[It.Value()].BatchIndex == *BatchIndex)
+		{
+			MatchedHandle = It.Value();
+			break;
+		}
+
+	if (MatchedHandle != INDEX_NONE)
+		RemoveDropInstance(MatchedHandle);
+}
+
+uint32 UItemDropSubsystem::MakeDropKey(const int32 ItemID, const FVector& Location)
+{
+	const FIntVector Quantized(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z));
+	const uint32 Key = HashCombineFast(GetTypeHash(ItemID), GetTypeHash(Quantized));
+	return Key != 0 ? Key : 1;
+}
+
+ABaseItemActor* UItemDropSubsystem::SpawnItemActor(UBaseItem* Item, const FTransform& Transform, const uint32 DropKey) const
+{
+	// 延迟生成，保证 BeginPlay 时物品实例已经就绪
+	ABaseItemActor* ItemActor = GetWorld()->SpawnActorDeferred<ABaseItemActor>(
+		Item->VisualActorClass,
+		Transform,
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn
+	);
+	if (!ItemActor) return nullptr;
+
+	ItemActor->Item = Item;
+	ItemActor->DropKey = DropKey;
+	ItemActor->FinishSpawning(Transform);
+	return ItemActor;
+}
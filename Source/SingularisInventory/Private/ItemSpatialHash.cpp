@@ -0,0 +1,130 @@
+/* =====================================================================
+ * ItemSpatialHash.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "ItemSpatialHash.h"
+
+FItemSpatialHash::FItemSpatialHash(const float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+	, InvCellSize(1.0f / CellSize)
+{
+}
+
+int32 FItemSpatialHash::Add(const FVector& Location)
+{
+	const int32 Handle = FreeHandles.Num() > 0 ? FreeHandles.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+
+	Entries[Handle].Location = Location;
+	LinkToCell(Handle, ToCell(Location));
+	++NumEntries;
+	return Handle;
+}
+
+void FItemSpatialHash::Remove(const int32 Handle)
+{
+	if (!IsValidHandle(Handle)) return;
+
+	UnlinkFromCell(Handle);
+	FreeHandles.Add(Handle);
+	--NumEntries;
+}
+
+void FItemSpatialHash::Update(const int32 Handle, const FVector& Location)
+{
+	if (!IsValidHandle(Handle)) return;
+
+	FEntry& Entry = Entries[Handle];
+	Entry.Location = Location;
+
+	const FIntPoint NewCell = ToCell(Location);
+	if (NewCell == Entry.Cell) return;
+
+	UnlinkFromCell(Handle);
+	LinkToCell(Handle, NewCell);
+}
+
+int32 FItemSpatialHash::FindNearest(const FVector& Center, const float MaxRadius, float* OutDistanceSquared) const
+{
+	int32 BestHandle = INDEX_NONE;
+	float BestDistanceSquared = MaxRadius * MaxRadius;
+
+	const FIntPoint Origin = ToCell(Center);
+	const int32 MaxRing = FMath::CeilToInt32(MaxRadius * InvCellSize) + 1;
+
+	// 由内向外逐圈扫描网格；第 Ring 圈中的点距离中心至少 (Ring - 1) * CellSize，
+	// 一旦当前最优距离不超过该下界即可提前结束
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (BestHandle != INDEX_NONE)
+		{
+			const float RingLowerBound = (Ring - 1) * CellSize;
+			if (RingLowerBound > 0.0f && RingLowerBound * RingLowerBound >= BestDistanceSquared)
+				break;
+		}
+
+		for (int32 X = -Ring; X <= Ring; ++X)
+		{
+			// 只访问该圈的边界单元：首末两列取整列，其余列只取上下两端
+			const bool bEdgeColumn = X == -Ring || X == Ring;
+			const int32 StepY = bEdgeColumn ? 1 : FMath::Max(2 * Ring, 1);
+
+			for (int32 Y = -Ring; Y <= Ring; Y += StepY)
+			{
+				const TArray<int32>* Cell = Cells.Find(FIntPoint(Origin.X + X, Origin.Y + Y));
+				if (!Cell) continue;
+
+				for (const int32 Handle : *Cell)
+				{
+					const float DistanceSquared = FVector::DistSquared(Entries[Handle].Location, Center);
+					if (DistanceSquared <= BestDistanceSquared)
+					{
+						BestDistanceSquared = DistanceSquared;
+						BestHandle = Handle;
+					}
+				}
+			}
+		}
+	}
+
+	if (OutDistanceSquared && BestHandle != INDEX_NONE)
+		*OutDistanceSquared = BestDistanceSquared;
+	return BestHandle;
+}
+
+SIZE_T FItemSpatialHash::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize() + FreeHandles.GetAllocatedSize() + Cells.GetAllocatedSize();
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : Cells)
+		Size += Pair.Value.GetAllocatedSize();
+	return Size;
+}
+
+void FItemSpatialHash::LinkToCell(const int32 Handle, const FIntPoint& Cell)
+{
+	TArray<int32>& CellHandles = Cells.FindOrAdd(Cell);
+	Entries[Handle].Cell = Cell;
+	Entries[Handle].IndexInCell = CellHandles.Add(Handle);
+}
+
+void FItemSpatialHash::UnlinkFromCell(const int32 Handle)
+{
+	FEntry& Entry = Entries[Handle];
+	TArray<int32>* CellHandles = Cells.Find(Entry.Cell);
+	check(CellHandles && CellHandles->IsValidIndex(Entry.IndexInCell));
+
+	// 与末尾元素交换后移除，并修正被移动条目记录的位置
+	const int32 Index = Entry.IndexInCell;
+	CellHandles->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (CellHandles->IsValidIndex(Index))
+		Entries[(*CellHandles)[Index]].IndexInCell = Index;
+
+	if (CellHandles->IsEmpty())
+		Cells.Remove(Entry.Cell);
+
+	Entry.IndexInCell = INDEX_NONE;
+}
@@ -0,0 +1,85 @@
+/* =====================================================================
+ * ItemSpatialSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "ItemSpatialSubsystem.h"
+
+#include "BaseItemActor.h"
+#include "InventoryMemory.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarItemSpatialCellSize(
+	TEXT("SI.SpatialCellSize"),
+	500.0f,
+	TEXT("世界物品空间哈希的网格单元边长（厘米），在世界创建时生效"),
+	ECVF_Default
+);
+
+void UItemSpatialSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	SpatialHash = FItemSpatialHash(CVarItemSpatialCellSize.GetValueOnGameThread());
+	HandleToActor.Reset();
+}
+
+void UItemSpatialSubsystem::Deinitialize()
+{
+	SpatialHash = FItemSpatialHash(SpatialHash.GetCellSize());
+	HandleToActor.Reset();
+	Super::Deinitialize();
+}
+
+int32 UItemSpatialSubsystem::RegisterItemActor(ABaseItemActor* ItemActor)
+{
+	if (!ItemActor) return INDEX_NONE;
+
+	const int32 Handle = SpatialHash.Add(ItemActor->GetActorLocation());
+	if (!HandleToActor.IsValidIndex(Handle))
+		HandleToActor.SetNum(Handle + 1);
+	HandleToActor[Handle] = ItemActor;
+	return Handle;
+}
+
+void UItemSpatialSubsystem::UnregisterItemActor(const int32 Handle)
+{
+	if (!SpatialHash.IsValidHandle(Handle)) return;
+
+	SpatialHash.Remove(Handle);
+	HandleToActor[Handle].Reset();
+}
+
+void UItemSpatialSubsystem::UpdateItemActor(const int32 Handle, const FVector& Location)
+{
+	SpatialHash.Update(Handle, Location);
+}
+
+void UItemSpatialSubsystem::QueryItemsInRadius(const FVector Location, const float Radius, TArray<ABaseItemActor*>& OutItems) const
+{
+	OutItems.Reset();
+
+	// 半径内的物品数量没有上限，排序用的临时数组分配在内存栈上
+	SingularisInventory::FInventoryScratchScope ScratchScope;
+	SingularisInventory::TArenaArray<TPair<float, ABaseItemActor*>> Found;
+	SpatialHash.ForEachInRadius(Location, Radius, [this, &Found](const int32 Handle, const float DistanceSquared)
+	{
+		if (ABaseItemActor* ItemActor = HandleToActor[Handle].Get())
+			Found.Emplace(DistanceSquared, ItemActor);
+	});
+
+	Found.Sort([](const TPair<float, ABaseItemActor*>& A, const TPair<float, ABaseItemActor*>& B) { return A.Key < B.Key; });
+
+	OutItems.Reserve(Found.Num());
+	for (const TPair<float, ABaseItemActor*>& Pair : Found)
+		OutItems.Add(Pair.Value);
+}
+
+ABaseItemActor* UItemSpatialSubsystem::FindNearestItem(const FVector Location, const float MaxRadius) const
+{
+	const int32 Handle = SpatialHash.FindNearest(Location, MaxRadius);
+	return Handle != INDEX_NONE ? HandleToActor[Handle].Get() : nullptr;
+}
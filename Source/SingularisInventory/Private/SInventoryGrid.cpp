@@ -0,0 +1,335 @@
+/* =====================================================================
+ * SInventoryGrid.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SInventoryGrid.h"
+
+#include "BaseItem.h"
+#include "InventoryManager.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Fonts/FontMeasure.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h"
+#include "Widgets/SInvalidationPanel.h"
+#include "Widgets/Layout/SUniformGridPanel.h"
+#include "Widgets/SLeafWidget.h"
+
+/**
+ * 网格中的单个槽位
+ *
+ * 只在内容变化时更新缓存并使自身绘制失效，绘制时直接使用缓存的画刷与文本尺寸。
+ */
+class SInventoryGridSlot : public SLeafWidget
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnSlotClicked, int32);
+
+	SLATE_BEGIN_ARGS(SInventoryGridSlot)
+		: _SlotIndex(INDEX_NONE)
+	{}
+		SLATE_ARGUMENT(int32, SlotIndex)
+		SLATE_ARGUMENT(TSharedPtr<const FInventoryGridStyle>, Style)
+		SLATE_EVENT(FOnSlotClicked, OnClicked)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs)
+	{
+		SlotIndex = InArgs._SlotIndex;
+		Style = InArgs._Style;
+		OnClicked = InArgs._OnClicked;
+		IconBrush.DrawAs = ESlateBrushDrawType::Image;
+	}
+
+	void SetContents(const UBaseItem* Item, const int32 InItemID, const int32 InQuantity)
+	{
+		const UObject* Icon = Item ? Item->IconAsset.Get() : nullptr;
+		if (InItemID == ItemID && InQuantity == Quantity && Icon == IconBrush.GetResourceObject()) return;
+
+		ItemID = InItemID;
+		Quantity = InQuantity;
+
+		// 内容变化后不再需要之前请求的图标
+		if (IconHandle.IsValid())
+		{
+			IconHandle->CancelHandle();
+			IconHandle.Reset();
+		}
+
+		SetIcon(const_cast<UObject*>(Icon));
+		if (Item && !Icon && !Item->IconAsset.IsNull())
+			RequestIcon(Item->IconAsset.ToSoftObjectPath());
+
+		// 数量文本与尺寸只在数量变化时重新计算
+		QuantityText = Quantity > 1 ? FText::AsNumber(Quantity) : FText::GetEmpty();
+		QuantityTextSize = FVector2D::ZeroVector;
+		if (!QuantityText.IsEmpty() && FSlateApplication::IsInitialized())
+			QuantityTextSize = FSlateApplication::Get().GetRenderer()->GetFontMeasureService()->Measure(QuantityText, Style->QuantityFont);
+
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	void SetSelected(const bool bInSelected)
+	{
+		if (bSelected == bInSelected) return;
+		bSelected = bInSelected;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	/** 由所属网格调用，向 GC 报告正在显示的图标 */
+	void AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		Collector.AddReferencedObject(IconObject);
+	}
+
+	virtual FVector2D ComputeDesiredSize(float) const override
+	{
+		return Style->SlotSize;
+	}
+
+	virtual int32 OnPaint(
+		const FPaintArgs& Args,
+		const FGeometry& AllottedGeometry,
+		const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements,
+		int32 LayerId,
+		const FWidgetStyle& InWidgetStyle,
+		bool bParentEnabled
+	) const override
+	{
+		const FSlateBrush& Background = bSelected ? Style->SelectedSlotBrush : Style->SlotBrush;
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(),
+			&Background,
+			ESlateDrawEffect::None,
+			Background.GetTint(InWidgetStyle)
+		);
+
+		if (IconBrush.GetResourceObject())
+		{
+			const FMargin& Padding = Style->IconPadding;
+			const FVector2D IconSize = AllottedGeometry.GetLocalSize() - FVector2D(Padding.GetTotalSpaceAlong<Orient_Horizontal>(), Padding.GetTotalSpaceAlong<Orient_Vertical>());
+			FSlateDrawElement::MakeBox(
+				OutDrawElements,
+				LayerId + 1,
+				AllottedGeometry.ToPaintGeometry(IconSize.ComponentMax(FVector2D::ZeroVector), FSlateLayoutTransform(FVector2D(Padding.Left, Padding.Top))),
+				&IconBrush,
+				ESlateDrawEffect::None,
+				InWidgetStyle.GetColorAndOpacityTint()
+			);
+		}
+
+		if (!QuantityText.IsEmpty())
+		{
+			const FVector2D Offset = AllottedGeometry.GetLocalSize() - QuantityTextSize - FVector2D(4.0f, 2.0f);
+			FSlateDrawElement::MakeText(
+				OutDrawElements,
+				LayerId + 2,
+				AllottedGeometry.ToPaintGeometry(QuantityTextSize, FSlateLayoutTransform(Offset)),
+				QuantityText,
+				Style->QuantityFont,
+				ESlateDrawEffect::None,
+				Style->QuantityColor.GetColor(InWidgetStyle) * InWidgetStyle.GetColorAndOpacityTint()
+			);
+		}
+
+		return LayerId + 2;
+	}
+
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override
+	{
+		if (MouseEvent.GetEffectingButton() != EKeys::LeftMouseButton) return FReply::Unhandled();
+
+		OnClicked.ExecuteIfBound(SlotIndex);
+		return FReply::Handled();
+	}
+
+private:
+	void SetIcon(UObject* Icon)
+	{
+		IconObject = Icon;
+		IconBrush.SetResourceObject(Icon);
+	}
+
+	void RequestIcon(const FSoftObjectPath& IconPath)
+	{
+		if (!UAssetManager::IsInitialized()) return;
+
+		// 图标加载完成后以当前内容重新设置画刷，期间槽位内容可能已经变化。
+		// 句柄保存在槽位上，槽位显示该图标期间资源不会被卸载
+		const TWeakPtr<SInventoryGridSlot> WeakSlot = SharedThis(this);
+		IconHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(IconPath, [WeakSlot, IconPath, RequestedItemID = ItemID]()
+		{
+			const TSharedPtr<SInventoryGridSlot> Slot = WeakSlot.Pin();
+			if (!Slot || Slot->ItemID != RequestedItemID) return;
+
+			Slot->SetIcon(IconPath.ResolveObject());
+			Slot->Invalidate(EInvalidateWidgetReason::Paint);
+		});
+	}
+
+	int32 SlotIndex = INDEX_NONE;
+	TSharedPtr<const FInventoryGridStyle> Style;
+	FOnSlotClicked OnClicked;
+
+	int32 ItemID = INDEX_NONE;
+	int32 Quantity = 0;
+	bool bSelected = false;
+
+	FSlateBrush IconBrush;
+
+	/** 画刷当前使用的图标，由所属网格报告给 GC */
+	TObjectPtr<UObject> IconObject = nullptr;
+
+	/** 正在加载或已加载的图标请求，槽位内容变化时释放 */
+	TSharedPtr<FStreamableHandle> IconHandle;
+
+	FText QuantityText;
+	FVector2D QuantityTextSize = FVector2D::ZeroVector;
+};
+
+void SInventoryGrid::Construct(const FArguments& InArgs)
+{
+	Inventory = InArgs._Inventory;
+	Columns = FMath::Max(InArgs._Columns, 1);
+	Style = MakeShared<FInventoryGridStyle>(InArgs._Style);
+
+	ChildSlot
+	[
+		SAssignNew(InvalidationPanel, SInvalidationPanel)
+		[
+			SAssignNew(GridPanel, SUniformGridPanel)
+		]
+	];
+
+	BindInventory();
+	RebuildSlots();
+}
+
+SInventoryGrid::~SInventoryGrid()
+{
+	UnbindInventory();
+}
+
+void SInventoryGrid::SetInventory(UInventoryManager* InInventory)
+{
+	if (Inventory.Get() == InInventory) return;
+
+	UnbindInventory();
+	Inventory = InInventory;
+	BindInventory();
+	RebuildSlots();
+}
+
+void SInventoryGrid::SetLayout(const int32 InColumns, const FInventoryGridStyle& InStyle)
+{
+	Columns = FMath::Max(InColumns, 1);
+
+	// 旧槽位仍持有旧副本，重建后才被释放
+	Style = MakeShared<FInventoryGridStyle>(InStyle);
+	RebuildSlots();
+}
+
+void SInventoryGrid::BindInventory()
+{
+	UInventoryManager* Manager = Inventory.Get();
+	if (!Manager) return;
+
+	SlotChangedHandle = Manager->OnSlotChangedNative.AddSP(this, &SInventoryGrid::HandleSlotChanged);
+	SelectChangedHandle = Manager->OnSlotSelectChangedNative.AddSP(this, &SInventoryGrid::HandleSelectChanged);
+}
+
+void SInventoryGrid::UnbindInventory()
+{
+	if (UInventoryManager* Manager = Inventory.Get())
+	{
+		Manager->OnSlotChangedNative.Remove(SlotChangedHandle);
+		Manager->OnSlotSelectChangedNative.Remove(SelectChangedHandle);
+	}
+	SlotChangedHandle.Reset();
+	SelectChangedHandle.Reset();
+}
+
+void SInventoryGrid::RebuildSlots()
+{
+	GridPanel->ClearChildren();
+	GridPanel->SetSlotPadding(Style->SlotPadding);
+	SlotWidgets.Reset();
+	SelectedSlot = INDEX_NONE;
+
+	const UInventoryManager* Manager = Inventory.Get();
+	if (!Manager) return;
+
+	SlotWidgets.Reserve(Manager->Slots.Num());
+	for (int32 i = 0; i < Manager->Slots.Num(); ++i)
+	{
+		TSharedRef<SInventoryGridSlot> SlotWidget = SNew(SInventoryGridSlot)
+			.SlotIndex(i)
+			.Style(Style)
+			.OnClicked(this, &SInventoryGrid::HandleSlotClicked);
+
+		GridPanel->AddSlot(i % Columns, i / Columns)[SlotWidget];
+		SlotWidgets.Add(SlotWidget);
+		RefreshSlot(i);
+	}
+
+	HandleSelectChanged(Inventory.Get(), Manager->SlotSelect);
+}
+
+void SInventoryGrid::RefreshSlot(const int32 SlotIndex) const
+{
+	const UInventoryManager* Manager = Inventory.Get();
+	if (!Manager || !Manager->Slots.IsValidIndex(SlotIndex) || !SlotWidgets.IsValidIndex(SlotIndex)) return;
+
+	const FInventorySlot& Slot = Manager->Slots[SlotIndex];
+	if (Slot.bIsEmpty)
+		SlotWidgets[SlotIndex]->SetContents(nullptr, INDEX_NONE, 0);
+	else
+		SlotWidgets[SlotIndex]->SetContents(Slot.GetItem(), Slot.ItemID, Slot.Quantity);
+}
+
+void SInventoryGrid::HandleSlotChanged(UInventoryManager* ChangedInventory, const int32 SlotIndex)
+{
+	// 槽位数量在运行时变化时整体重建，否则只刷新变化的槽位
+	if (ChangedInventory->Slots.Num() != SlotWidgets.Num())
+		RebuildSlots();
+	else
+		RefreshSlot(SlotIndex);
+}
+
+void SInventoryGrid::HandleSelectChanged(UInventoryManager* ChangedInventory, const int32 SelectIndex)
+{
+	if (SlotWidgets.IsValidIndex(SelectedSlot))
+		SlotWidgets[SelectedSlot]->SetSelected(false);
+
+	SelectedSlot = SelectIndex;
+	if (SlotWidgets.IsValidIndex(SelectedSlot))
+		SlotWidgets[SelectedSlot]->SetSelected(true);
+}
+
+void SInventoryGrid::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddPropertyReferencesWithStructARO(FInventoryGridStyle::StaticStruct(), &Style.Get());
+
+	for (const TSharedPtr<SInventoryGridSlot>& SlotWidget : SlotWidgets)
+		SlotWidget->AddReferencedObjects(Collector);
+}
+
+FString SInventoryGrid::GetReferencerName() const
+{
+	return TEXT("SInventoryGrid");
+}
+
+void SInventoryGrid::HandleSlotClicked(const int32 SlotIndex) const
+{
+	if (UInventoryManager* Manager = Inventory.Get())
+		Manager->SetSlotSelect(SlotIndex);
+}
@@ -9,8 +9,12 @@
 
 #include "SingularisInventory.h"
 
+#include "InventoryJournal.h"
+
 #define LOCTEXT_NAMESPACE "FSingularisInventoryModule"
 
+LLM_DEFINE_TAG(SingularisInventory);
+
 void FSingularisInventoryModule::StartupModule()
 {
 	// 这段代码将在你的模块加载到内存后执行；具体的时间安排在每个模块的.uplugin文件中指定。
@@ -20,6 +24,7 @@ void FSingularisInventoryModule::ShutdownModule()
 {
 	// 此函数可能在关闭时被调用以清理你的模块。对于支持动态重载的模块，
 	// 我们会在卸载模块之前调用此函数。
+	FInventoryJournal::ShutdownWriter();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,102 @@
+/* =====================================================================
+ * InventoryCooldownWheelSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryCooldownWheel.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryCooldownWheelSpec,
+	"SingularisInventory.CooldownWheel",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+END_DEFINE_SPEC(FInventoryCooldownWheelSpec)
+
+void FInventoryCooldownWheelSpec::Define()
+{
+	// 刻度取 0.25 秒，累加时没有浮点误差
+	static constexpr float TickSeconds = 0.25f;
+	static constexpr int32 NumBuckets = 4;
+
+	It("should expire a cooldown after its rounded-up number of ticks", [this]
+	{
+		FInventoryCooldownWheel Wheel(TickSeconds, NumBuckets);
+		Wheel.Start(1, 0.6f);
+		TestEqual(TEXT("开始时剩余冷却"), Wheel.GetRemaining(1), 0.75f);
+
+		Wheel.Advance(0.5f);
+		TestTrue(TEXT("两个刻度后仍在冷却"), Wheel.IsCoolingDown(1));
+
+		Wheel.Advance(TickSeconds);
+		TestFalse(TEXT("向上取整的第三个刻度到期"), Wheel.IsCoolingDown(1));
+		TestTrue(TEXT("到期后不再保留条目"), Wheel.IsEmpty());
+	});
+
+	It("should not expire early when started between ticks", [this]
+	{
+		FInventoryCooldownWheel Wheel(TickSeconds, NumBuckets);
+
+		// 另一个冷却保持时间轮运转，推进半个刻度后再开始
+		Wheel.Start(2, 10.0f);
+		Wheel.Advance(0.125f);
+		Wheel.Start(1, 0.5f);
+		TestTrue(TEXT("剩余冷却不少于完整时长"), Wheel.GetRemaining(1) >= 0.5f);
+
+		// 旧实现在此处的第二个刻度边界提前到期
+		Wheel.Advance(0.375f);
+		TestTrue(TEXT("经过两个刻度边界后仍在冷却"), Wheel.IsCoolingDown(1));
+
+		Wheel.Advance(TickSeconds);
+		TestFalse(TEXT("满足完整时长后的刻度到期"), Wheel.IsCoolingDown(1));
+	});
+
+	It("should keep cooldowns longer than one wheel rotation until they expire", [this]
+	{
+		FInventoryCooldownWheel Wheel(TickSeconds, NumBuckets);
+		Wheel.Start(1, 3.0f);
+
+		// 12 个刻度，时间轮每圈 4 个刻度
+		for (int32 Tick = 1; Tick < 12; ++Tick)
+		{
+			Wheel.Advance(TickSeconds);
+			if (!TestTrue(FString::Printf(TEXT("第 %d 个刻度仍在冷却"), Tick), Wheel.IsCoolingDown(1)))
+				return;
+		}
+
+		Wheel.Advance(TickSeconds);
+		TestFalse(TEXT("第 12 个刻度到期"), Wheel.IsCoolingDown(1));
+	});
+
+	It("should use the latest duration when a cooldown is refreshed", [this]
+	{
+		FInventoryCooldownWheel Wheel(TickSeconds, NumBuckets);
+		Wheel.Start(1, 0.25f);
+		Wheel.Start(1, 1.0f);
+
+		// 旧条目所在的桶先被处理，不能提前移除刷新后的冷却
+		Wheel.Advance(0.5f);
+		TestTrue(TEXT("刷新后的冷却仍在进行"), Wheel.IsCoolingDown(1));
+		TestEqual(TEXT("刷新后的剩余冷却"), Wheel.GetRemaining(1), 0.5f);
+
+		Wheel.Advance(0.5f);
+		TestFalse(TEXT("刷新后的冷却到期"), Wheel.IsCoolingDown(1));
+	});
+
+	It("should clear a cooldown started with a non-positive duration", [this]
+	{
+		FInventoryCooldownWheel Wheel(TickSeconds, NumBuckets);
+		Wheel.Start(1, 1.0f);
+		Wheel.Start(1, 0.0f);
+		TestFalse(TEXT("冷却被清除"), Wheel.IsCoolingDown(1));
+		TestTrue(TEXT("没有剩余条目"), Wheel.IsEmpty());
+	});
+}
+
+#endif
@@ -0,0 +1,211 @@
+/* =====================================================================
+ * InventoryCraftingSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryCraftingSubsystem.h"
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+#include "InventoryStressTest.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryCraftingSpec,
+	"SingularisInventory.Crafting",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	/** 测试物品使用的 ItemID，避开压力测试与其他测试保留的区间 */
+	static constexpr int32 WoodID = MAX_int32 - 0x20020;
+	static constexpr int32 StoneID = MAX_int32 - 0x20021;
+	static constexpr int32 AxeID = MAX_int32 - 0x20022;
+
+	/** 独立的合成子系统实例，测试配方不进入引擎中的全局索引 */
+	UInventoryCraftingSubsystem* Crafting = nullptr;
+	UInventoryManager* Inventory = nullptr;
+	TMap<int32, UBaseItem*> Definitions;
+
+	void RegisterDefinition(const int32 ItemID, const int32 MaxStackSize)
+	{
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = ItemID;
+		Item->MaxStackSize = MaxStackSize;
+		Definitions.Add(ItemID, Item);
+		UInventoryItemRegistry::Get()->RegisterItemDefinition(ItemID, Item);
+	}
+
+	static FInventoryRecipe MakeRecipe(const FName Name, TArray<FInventoryRecipeIngredient> Ingredients, const int32 ResultQuantity)
+	{
+		FInventoryRecipe Recipe;
+		Recipe.RecipeName = Name;
+		Recipe.Ingredients = MoveTemp(Ingredients);
+		Recipe.ResultItemID = AxeID;
+		Recipe.ResultQuantity = ResultQuantity;
+		return Recipe;
+	}
+
+	static FInventoryRecipeIngredient Ingredient(const int32 ItemID, const int32 Quantity)
+	{
+		FInventoryRecipeIngredient Result;
+		Result.ItemID = ItemID;
+		Result.Quantity = Quantity;
+		return Result;
+	}
+
+	/** 注册只包含给定配方的配方集，返回第一个配方的索引 */
+	int32 RegisterRecipes(TArray<FInventoryRecipe> Recipes)
+	{
+		const int32 FirstIndex = Crafting->NumRecipes();
+		UInventoryRecipeBook* Book = NewObject<UInventoryRecipeBook>(Crafting);
+		Book->Recipes = MoveTemp(Recipes);
+		Crafting->RegisterRecipeBook(Book);
+		return FirstIndex;
+	}
+END_DEFINE_SPEC(FInventoryCraftingSpec)
+
+void FInventoryCraftingSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Crafting = NewObject<UInventoryCraftingSubsystem>();
+		Crafting->AddToRoot();
+
+		Inventory = NewObject<UInventoryManager>();
+		Inventory->AddToRoot();
+		Inventory->Slots.SetNum(4);
+
+		if (UInventoryItemRegistry::Get())
+		{
+			RegisterDefinition(WoodID, 2);
+			RegisterDefinition(StoneID, 5);
+			RegisterDefinition(AxeID, 1);
+		}
+	});
+
+	AfterEach([this]
+	{
+		Crafting->UntrackInventory(Inventory);
+		Crafting->RemoveFromRoot();
+		Crafting = nullptr;
+
+		Inventory->RemoveFromRoot();
+		Inventory = nullptr;
+
+		for (const TPair<int32, UBaseItem*>& Pair : Definitions)
+		{
+			if (UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get())
+				Registry->UnregisterItemDefinition(Pair.Key, Pair.Value);
+			Pair.Value->RemoveFromRoot();
+		}
+		Definitions.Reset();
+	});
+
+	Describe("Compile", [this]
+	{
+		It("should skip recipes without valid ingredients", [this]
+		{
+			AddExpectedError(TEXT("没有有效材料"), EAutomationExpectedErrorFlags::Contains, 2);
+			RegisterRecipes({
+				MakeRecipe(TEXT("Free"), {}, 1),
+				MakeRecipe(TEXT("Invalid"), {Ingredient(INDEX_NONE, 1), Ingredient(WoodID, 0)}, 1),
+				MakeRecipe(TEXT("Axe"), {Ingredient(WoodID, 1)}, 1),
+			});
+
+			TestEqual(TEXT("只编译有效配方"), Crafting->NumRecipes(), 1);
+			TestEqual(TEXT("无效配方没有名称索引"), Crafting->FindRecipe(TEXT("Free")), INDEX_NONE);
+
+			TArray<int32> Craftable;
+			Crafting->GetCraftableRecipes(Inventory, Craftable);
+			TestTrue(TEXT("空库存没有可合成配方"), Craftable.IsEmpty());
+		});
+
+		It("should merge repeated ingredients", [this]
+		{
+			const int32 RecipeIndex = RegisterRecipes({MakeRecipe(TEXT("Axe"), {Ingredient(WoodID, 1), Ingredient(WoodID, 2)}, 1)});
+			const FInventoryRecipe Recipe = Crafting->GetRecipe(RecipeIndex);
+			if (!TestEqual(TEXT("合并为一个材料条目"), Recipe.Ingredients.Num(), 1)) return;
+			TestEqual(TEXT("合并后的数量"), Recipe.Ingredients[0].Quantity, 3);
+		});
+	});
+
+	Describe("Tracker", [this]
+	{
+		It("should follow slot changes incrementally", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+
+			const int32 RecipeIndex = RegisterRecipes({MakeRecipe(TEXT("Axe"), {Ingredient(WoodID, 3), Ingredient(StoneID, 1)}, 1)});
+			Crafting->TrackInventory(Inventory);
+			TestFalse(TEXT("空库存不可合成"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+
+			Inventory->TryAddItemsByID(WoodID, 3);
+			TestEqual(TEXT("跨槽位统计材料数量"), Crafting->GetItemCount(Inventory, WoodID), 3);
+			TestFalse(TEXT("缺少石头时不可合成"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+
+			Inventory->TryAddItemByID(StoneID);
+			TestTrue(TEXT("材料齐全后可合成"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+
+			Inventory->RemoveItemCount(0, 1);
+			TestEqual(TEXT("移除后的材料数量"), Crafting->GetItemCount(Inventory, WoodID), 2);
+			TestFalse(TEXT("材料不足后不可合成"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+
+			Inventory->SwapSlots(0, 3);
+			Inventory->TryAddItemByID(WoodID);
+			TestTrue(TEXT("交换槽位后补足材料"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+		});
+	});
+
+	Describe("Craft", [this]
+	{
+		It("should remove ingredients in one batch and add the result", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+
+			const int32 RecipeIndex = RegisterRecipes({MakeRecipe(TEXT("Axe"), {Ingredient(WoodID, 3), Ingredient(StoneID, 1)}, 1)});
+
+			// 木头占用槽位 0（2 个）与槽位 1（1 个），石头在槽位 2
+			Inventory->TryAddItemsByID(WoodID, 3);
+			Inventory->TryAddItemByID(StoneID);
+
+			TMap<int32, int32> Notifications;
+			const FDelegateHandle Handle = Inventory->OnSlotChangedNative.AddLambda([&Notifications](UInventoryManager*, const int32 SlotIndex)
+			{
+				++Notifications.FindOrAdd(SlotIndex);
+			});
+
+			TestTrue(TEXT("合成成功"), Crafting->Craft(Inventory, RecipeIndex));
+			Inventory->OnSlotChangedNative.Remove(Handle);
+
+			TestEqual(TEXT("木头被消耗"), Crafting->GetItemCount(Inventory, WoodID), 0);
+			TestEqual(TEXT("石头被消耗"), Crafting->GetItemCount(Inventory, StoneID), 0);
+			TestEqual(TEXT("产物放入第一个空槽位"), Inventory->Slots[0].ItemID, AxeID);
+			TestEqual(TEXT("材料槽位只广播一次"), Notifications.FindRef(1), 1);
+			TestEqual(TEXT("材料槽位只广播一次"), Notifications.FindRef(2), 1);
+			TestEqual(TEXT("放入产物的槽位在两步中各广播一次"), Notifications.FindRef(0), 2);
+			TestFalse(TEXT("合成后材料不足"), Crafting->IsRecipeCraftable(Inventory, RecipeIndex));
+		});
+
+		It("should leave the inventory unchanged when the result does not fit", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+
+			// 产物不可堆叠，材料腾出的三个槽位加一个空槽位放不下五个
+			const int32 RecipeIndex = RegisterRecipes({MakeRecipe(TEXT("Axes"), {Ingredient(WoodID, 3), Ingredient(StoneID, 1)}, 5)});
+			Inventory->TryAddItemsByID(WoodID, 3);
+			Inventory->TryAddItemByID(StoneID);
+
+			TestFalse(TEXT("产物放不下时合成失败"), Crafting->Craft(Inventory, RecipeIndex));
+			TestEqual(TEXT("木头保持不变"), Crafting->GetItemCount(Inventory, WoodID), 3);
+			TestEqual(TEXT("石头保持不变"), Crafting->GetItemCount(Inventory, StoneID), 1);
+			TestEqual(TEXT("槽位 0 保持不变"), Inventory->Slots[0].Quantity, 2);
+		});
+	});
+}
+
+#endif
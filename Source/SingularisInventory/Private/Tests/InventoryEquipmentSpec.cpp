@@ -0,0 +1,186 @@
+/* =====================================================================
+ * InventoryEquipmentSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryEquipment.h"
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+#include "InventoryStressTest.h"
+#include "InventoryTestWorld.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryEquipmentSpec,
+	"SingularisInventory.Equipment",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	/** 紧凑存储的可佩戴物品使用的 ItemID，避开压力测试与其他测试保留的区间 */
+	static constexpr int32 CompactRingID = MAX_int32 - 0x20010;
+
+	TUniquePtr<SingularisInventory::Tests::FInventoryTestWorld> TestWorld;
+	UInventoryManager* Inventory = nullptr;
+	UInventoryEquipment* Equipment = nullptr;
+	TArray<UBaseItem*> Items;
+
+	UBaseItem* MakeAccessory(const int32 ItemID, const FName SlotType, const float Additive, const float Multiplier)
+	{
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = ItemID;
+		Item->bAccessory = true;
+		Item->EquipmentSlotType = SlotType;
+		FItemStatModifier& Modifier = Item->StatModifiers.AddDefaulted_GetRef();
+		Modifier.StatName = TEXT("Attack");
+		Modifier.Additive = Additive;
+		Modifier.Multiplier = Multiplier;
+		Items.Add(Item);
+		return Item;
+	}
+
+	UBaseItem* MakeFiller(const int32 ItemID)
+	{
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = ItemID;
+		Items.Add(Item);
+		return Item;
+	}
+
+	/** 在同一个 Actor 上注册库存与装备组件，装备组件开始游戏时找到库存 */
+	void Setup(const int32 NumSlots)
+	{
+		AActor* Owner = TestWorld->Get()->SpawnActor<AActor>();
+
+		Inventory = NewObject<UInventoryManager>(Owner);
+		Inventory->Slots.SetNum(NumSlots);
+		Inventory->RegisterComponent();
+
+		Equipment = NewObject<UInventoryEquipment>(Owner);
+		Equipment->EquipmentSlots.SetNum(1);
+		Equipment->EquipmentSlots[0].SlotType = TEXT("Weapon");
+		Equipment->RegisterComponent();
+	}
+
+	void TestAttack(const TCHAR* What, const float Additive, const float Multiplier)
+	{
+		const FEquipmentStatTotal Total = Equipment->GetStatTotal(TEXT("Attack"));
+		TestEqual(*FString::Printf(TEXT("%s：加值合计"), What), Total.Additive, Additive);
+		TestEqual(*FString::Printf(TEXT("%s：百分比加成合计"), What), Total.Multiplier, Multiplier);
+	}
+END_DEFINE_SPEC(FInventoryEquipmentSpec)
+
+void FInventoryEquipmentSpec::Define()
+{
+	BeforeEach([this]
+	{
+		TestWorld = MakeUnique<SingularisInventory::Tests::FInventoryTestWorld>();
+	});
+
+	AfterEach([this]
+	{
+		for (UBaseItem* Item : Items)
+			Item->RemoveFromRoot();
+		Items.Reset();
+		Inventory = nullptr;
+		Equipment = nullptr;
+		TestWorld.Reset();
+	});
+
+	Describe("Stat totals", [this]
+	{
+		It("should include an item once it is equipped", [this]
+		{
+			Setup(4);
+			UBaseItem* Sword = MakeAccessory(1, TEXT("Weapon"), 10.0f, 0.1f);
+			Inventory->TryAddItem(Sword);
+
+			TestTrue(TEXT("佩戴物品"), Equipment->Equip(0));
+			TestTrue(TEXT("物品离开库存"), Inventory->IsSlotEmpty(0));
+			TestEqual(TEXT("物品进入装备槽位"), Equipment->EquipmentSlots[0].Item, Sword);
+			TestAttack(TEXT("佩戴后"), 10.0f, 0.1f);
+			TestEqual(TEXT("按公式计算属性"), Equipment->ApplyStat(TEXT("Attack"), 90.0f), 110.0f);
+		});
+
+		It("should replace the totals when equipping over another item", [this]
+		{
+			Setup(4);
+			UBaseItem* Sword = MakeAccessory(1, TEXT("Weapon"), 10.0f, 0.1f);
+			UBaseItem* Axe = MakeAccessory(2, TEXT("Weapon"), 4.0f, 0.25f);
+			Inventory->TryAddItem(Sword);
+			Inventory->TryAddItem(Axe);
+
+			TestTrue(TEXT("佩戴第一件"), Equipment->Equip(0));
+			TestTrue(TEXT("替换为第二件"), Equipment->Equip(1));
+			TestEqual(TEXT("装备槽位为第二件"), Equipment->EquipmentSlots[0].Item, Axe);
+			TestAttack(TEXT("替换后"), 4.0f, 0.25f);
+			TestEqual(TEXT("原有装备放回库存"), Inventory->GetItemInSlot(0), Sword);
+		});
+
+		It("should drop the stat entry once the last contributor is unequipped", [this]
+		{
+			Setup(4);
+			UBaseItem* Sword = MakeAccessory(1, TEXT("Weapon"), 10.0f, 0.1f);
+			Inventory->TryAddItem(Sword);
+
+			TestTrue(TEXT("佩戴物品"), Equipment->Equip(0));
+			TestTrue(TEXT("卸下物品"), Equipment->Unequip(0));
+			TestNull(TEXT("没有装备提供修正"), Equipment->FindStatTotal(TEXT("Attack")));
+			TestEqual(TEXT("未修正的属性保持基础值"), Equipment->ApplyStat(TEXT("Attack"), 90.0f), 90.0f);
+			TestEqual(TEXT("物品回到库存"), Inventory->GetItemInSlot(0), Sword);
+		});
+	});
+
+	Describe("Full inventory", [this]
+	{
+		It("should keep the item equipped when unequipping has nowhere to go", [this]
+		{
+			Setup(1);
+			UBaseItem* Sword = MakeAccessory(1, TEXT("Weapon"), 10.0f, 0.1f);
+			Inventory->TryAddItem(Sword);
+			TestTrue(TEXT("佩戴物品"), Equipment->Equip(0));
+			Inventory->TryAddItem(MakeFiller(3));
+
+			TestFalse(TEXT("库存已满时卸下失败"), Equipment->Unequip(0));
+			TestEqual(TEXT("物品仍在装备槽位"), Equipment->EquipmentSlots[0].Item, Sword);
+			TestAttack(TEXT("卸下失败后"), 10.0f, 0.1f);
+		});
+
+		It("should restore the source slot when the previous item cannot be returned", [this]
+		{
+			UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get();
+			if (!TestNotNull(TEXT("物品注册表"), Registry)) return;
+
+			UBaseItem* Ring = MakeAccessory(CompactRingID, TEXT("Weapon"), 2.0f, 0.0f);
+			Ring->MaxStackSize = 5;
+			Registry->RegisterItemDefinition(CompactRingID, Ring);
+
+			Setup(2);
+			UBaseItem* Sword = MakeAccessory(1, TEXT("Weapon"), 10.0f, 0.1f);
+			Inventory->TryAddItem(Sword);
+			TestTrue(TEXT("佩戴物品"), Equipment->Equip(0));
+
+			// 槽位 0 为两件堆叠的紧凑装备，槽位 1 被占满，取出一件后原有装备无处可放
+			Inventory->TryAddItemsByID(CompactRingID, 2);
+			Inventory->TryAddItem(MakeFiller(3));
+			Inventory->SetSlotAttribute(0, TEXT("Enchant"), 7);
+
+			TestFalse(TEXT("原有装备放不回库存时佩戴失败"), Equipment->Equip(0));
+			TestEqual(TEXT("原槽位数量恢复"), Inventory->Slots[0].Quantity, 2);
+			TestEqual(TEXT("原槽位物品不变"), Inventory->Slots[0].ItemID, CompactRingID);
+			TestEqual(TEXT("原槽位实例属性不变"), Inventory->GetSlotAttribute(0, TEXT("Enchant")), 7);
+			TestEqual(TEXT("原有装备仍在装备槽位"), Equipment->EquipmentSlots[0].Item, Sword);
+			TestAttack(TEXT("佩戴失败后"), 10.0f, 0.1f);
+
+			Registry->UnregisterItemDefinition(CompactRingID, Ring);
+		});
+	});
+}
+
+#endif
@@ -0,0 +1,110 @@
+/* =====================================================================
+ * InventoryHeadlessSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryManager.h"
+#include "InventoryStressTest.h"
+#include "InventoryTestWorld.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryHeadlessSpec,
+	"SingularisInventory.Headless",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	TUniquePtr<SingularisInventory::Tests::FInventoryTestWorld> TestWorld;
+	UBaseItem* Potion = nullptr;
+
+	/** 在没有任何控制器的 Actor 上注册库存组件，拥有者已开始游戏，注册时即执行 BeginPlay */
+	UInventoryManager* AddManager(AActor* Owner) const
+	{
+		UInventoryManager* Manager = NewObject<UInventoryManager>(Owner);
+		Manager->Slots.SetNum(4);
+		Manager->RegisterComponent();
+		return Manager;
+	}
+
+	void TestHeadless(const UInventoryManager* Manager)
+	{
+		TestTrue(TEXT("组件已开始游戏"), Manager->HasBegunPlay());
+		TestNull(TEXT("没有控制器时不创建界面"), Manager->InventoryWidget);
+		TestEqual(TEXT("界面内存为 0"), Manager->GetMemoryUsage().WidgetBytes, static_cast<int64>(0));
+	}
+END_DEFINE_SPEC(FInventoryHeadlessSpec)
+
+void FInventoryHeadlessSpec::Define()
+{
+	BeforeEach([this]
+	{
+		TestWorld = MakeUnique<SingularisInventory::Tests::FInventoryTestWorld>();
+
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = 1;
+		Item->bConsumable = true;
+		Item->DisplayName = FText::FromString(TEXT("Health Potion"));
+		Potion = Item;
+	});
+
+	AfterEach([this]
+	{
+		Potion->RemoveFromRoot();
+		Potion = nullptr;
+		TestWorld.Reset();
+	});
+
+	Describe("On a plain actor", [this]
+	{
+		It("begins play without a widget or input bindings", [this]
+		{
+			AActor* Chest = TestWorld->Get()->SpawnActor<AActor>();
+			const UInventoryManager* Manager = AddManager(Chest);
+			TestHeadless(Manager);
+		});
+
+		It("adds, uses and removes items", [this]
+		{
+			AActor* Chest = TestWorld->Get()->SpawnActor<AActor>();
+			UInventoryManager* Manager = AddManager(Chest);
+
+			TestTrue(TEXT("添加物品"), Manager->TryAddItem(Potion));
+			TestTrue(TEXT("添加第二个物品"), Manager->TryAddItem(Potion));
+
+			// 使用请求在下一次 Tick 中处理，没有玩家控制器时同样执行并消耗物品
+			TestTrue(TEXT("提交使用请求"), Manager->UseItem(0));
+			Manager->TickComponent(0.1f, LEVELTICK_All, nullptr);
+			const int32 Remaining = Manager->IsSlotEmpty(0) ? 0 : Manager->Slots[0].Quantity;
+			TestEqual(TEXT("消耗品被使用一次"), Remaining + (Manager->IsSlotEmpty(1) ? 0 : Manager->Slots[1].Quantity), 1);
+
+			for (int32 i = 0; i < Manager->Slots.Num(); ++i)
+				if (!Manager->IsSlotEmpty(i))
+					TestTrue(TEXT("移除物品"), Manager->RemoveItemByIndex(i));
+			TestTrue(TEXT("槽位已清空"), Manager->IsSlotEmpty(0) && Manager->IsSlotEmpty(1));
+			TestHeadless(Manager);
+		});
+	});
+
+	Describe("On an unpossessed pawn", [this]
+	{
+		It("stays headless and keeps working", [this]
+		{
+			APawn* Pawn = TestWorld->Get()->SpawnActor<APawn>();
+			UInventoryManager* Manager = AddManager(Pawn);
+			TestNull(TEXT("Pawn 没有控制器"), Pawn->GetController());
+			TestHeadless(Manager);
+
+			TestTrue(TEXT("添加物品"), Manager->TryAddItem(Potion));
+			TestEqual(TEXT("物品在第一个槽位"), Manager->GetItemInSlot(0), Potion);
+		});
+	});
+}
+
+#endif
@@ -0,0 +1,93 @@
+/* =====================================================================
+ * InventoryItemAttributesSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryItemAttributes.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryItemAttributesSpec,
+	"SingularisInventory.ItemAttributes",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	static FInventoryItemAttributes RoundTrip(FInventoryItemAttributes& Source)
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Source.Serialize(Writer);
+
+		FInventoryItemAttributes Loaded;
+		FMemoryReader Reader(Bytes);
+		Loaded.Serialize(Reader);
+		return Loaded;
+	}
+END_DEFINE_SPEC(FInventoryItemAttributesSpec)
+
+void FInventoryItemAttributesSpec::Define()
+{
+	It("should compare and hash independently of insertion order", [this]
+	{
+		FInventoryItemAttributes First;
+		First.Set(TEXT("Durability"), 80);
+		First.Set(TEXT("Enchant"), 3);
+		First.Set(TEXT("Quality"), 2);
+
+		FInventoryItemAttributes Second;
+		Second.Set(TEXT("Quality"), 2);
+		Second.Set(TEXT("Durability"), 80);
+		Second.Set(TEXT("Enchant"), 3);
+
+		TestTrue(TEXT("相等"), First == Second);
+		TestEqual(TEXT("哈希相同"), GetTypeHash(First), GetTypeHash(Second));
+
+		Second.Set(TEXT("Enchant"), 4);
+		TestTrue(TEXT("值不同则不相等"), First != Second);
+	});
+
+	It("should restore equality and hash after a remove", [this]
+	{
+		FInventoryItemAttributes Attributes;
+		Attributes.Set(TEXT("Quality"), 1);
+		const FInventoryItemAttributes Original = Attributes;
+
+		Attributes.Set(TEXT("Durability"), 50);
+		TestTrue(TEXT("移除存在的键"), Attributes.Remove(TEXT("Durability")));
+		TestFalse(TEXT("移除不存在的键"), Attributes.Remove(TEXT("Durability")));
+		TestTrue(TEXT("移除后相等"), Attributes == Original);
+		TestEqual(TEXT("移除后哈希相同"), GetTypeHash(Attributes), GetTypeHash(Original));
+	});
+
+	It("should keep values, equality and hash after a serialize round trip", [this]
+	{
+		FInventoryItemAttributes Attributes;
+		for (int32 i = 0; i < FInventoryItemAttributes::InlineCapacity + 2; ++i)
+			Attributes.Set(*FString::Printf(TEXT("Stat_%d"), i), i * 10 - 7);
+
+		const FInventoryItemAttributes Loaded = RoundTrip(Attributes);
+		TestEqual(TEXT("条目数量"), Loaded.Num(), Attributes.Num());
+		TestTrue(TEXT("相等"), Loaded == Attributes);
+		TestEqual(TEXT("哈希相同"), GetTypeHash(Loaded), GetTypeHash(Attributes));
+		TestEqual(TEXT("读取值"), Loaded.Get(TEXT("Stat_3")), 23);
+		TestNull(TEXT("不存在的键"), Loaded.Find(TEXT("Missing")));
+	});
+
+	It("should round trip empty attributes", [this]
+	{
+		FInventoryItemAttributes Empty;
+		const FInventoryItemAttributes Loaded = RoundTrip(Empty);
+		TestTrue(TEXT("为空"), Loaded.IsEmpty());
+		TestTrue(TEXT("相等"), Loaded == Empty);
+		TestEqual(TEXT("哈希相同"), GetTypeHash(Loaded), GetTypeHash(Empty));
+	});
+}
+
+#endif
@@ -0,0 +1,202 @@
+/* =====================================================================
+ * InventoryJournalSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryJournal.h"
+#include "BaseItem.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryJournalSpec,
+	"SingularisInventory.Journal",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	static constexpr int32 NumSlots = 4;
+
+	/** 每个用例使用独立的日志名，结束后删除所有文件 */
+	FString Name;
+
+	TArray<FInventoryJournalSlotState> Slots;
+	TMap<int32, FString> ItemClasses;
+
+	uint64 ReplayJournal()
+	{
+		Slots.Reset();
+		Slots.SetNum(NumSlots);
+		return FInventoryJournal::Replay(Name, Slots, ItemClasses);
+	}
+
+	/** 写出全部记录并释放日志，释放后文件只由重放读取 */
+	static void Close(TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>& Journal)
+	{
+		Journal->Flush();
+		Journal.Reset();
+	}
+
+	static FInventoryItemAttributes MakeAttributes(const int32 Quality)
+	{
+		FInventoryItemAttributes Attributes;
+		Attributes.Set(TEXT("Quality"), Quality);
+		Attributes.Set(TEXT("Durability"), 100 - Quality);
+		return Attributes;
+	}
+
+	void TestSlot(const int32 SlotIndex, const int32 ItemID, const int32 Quantity, const FInventoryItemAttributes& Attributes = {})
+	{
+		const FInventoryJournalSlotState& State = Slots[SlotIndex];
+		TestEqual(FString::Printf(TEXT("槽位 %d 的物品ID"), SlotIndex), State.ItemID, ItemID);
+		TestEqual(FString::Printf(TEXT("槽位 %d 的数量"), SlotIndex), State.Quantity, Quantity);
+		TestTrue(FString::Printf(TEXT("槽位 %d 的实例属性"), SlotIndex), State.Attributes == Attributes);
+	}
+END_DEFINE_SPEC(FInventoryJournalSpec)
+
+void FInventoryJournalSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Name = FString::Printf(TEXT("AutomationSpec_%s"), *FGuid::NewGuid().ToString());
+		ItemClasses.Reset();
+	});
+
+	AfterEach([this]
+	{
+		IFileManager& FileManager = IFileManager::Get();
+		const FString JournalPath = FInventoryJournal::GetJournalPath(Name);
+		const FString SnapshotPath = FInventoryJournal::GetSnapshotPath(Name);
+		FileManager.Delete(*JournalPath, false, false, true);
+		FileManager.Delete(*(JournalPath + TEXT(".corrupt")), false, false, true);
+		FileManager.Delete(*SnapshotPath, false, false, true);
+		FileManager.Delete(*(SnapshotPath + TEXT(".tmp")), false, false, true);
+	});
+
+	It("should write the remaining records of a journal handed to the writer thread", [this]
+	{
+		TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = FInventoryJournal::Open(Name, 1);
+		Journal->RecordSet(0, 10, 3, MakeAttributes(1), nullptr);
+		Journal->RecordSet(2, 11, 1, {}, nullptr);
+		const uint64 LastSequence = Journal->GetLastSequence();
+
+		FInventoryJournal::Close(MoveTemp(Journal));
+		TestFalse(TEXT("关闭后不再持有日志"), Journal.IsValid());
+
+		// 重放会先写出仍在等待写入线程的日志，立即重新打开同名日志也能读到全部记录
+		TestEqual(TEXT("重放到最后一条记录"), ReplayJournal(), LastSequence);
+		TestSlot(0, 10, 3, MakeAttributes(1));
+		TestSlot(2, 11, 1);
+	});
+
+	It("should replay set, swap and clear records with attributes and item classes", [this]
+	{
+		TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = FInventoryJournal::Open(Name, 1);
+		Journal->RecordSet(0, 10, 3, MakeAttributes(2), UBaseItem::StaticClass());
+		Journal->RecordSet(1, 11, 1, {}, nullptr);
+		Journal->RecordSwap(0, 1);
+		Journal->RecordClear(0);
+		Journal->RecordSet(NumSlots + 3, 12, 1, {}, nullptr);
+		const uint64 LastSequence = Journal->GetLastSequence();
+		Close(Journal);
+
+		TestEqual(TEXT("重放到最后一条记录"), ReplayJournal(), LastSequence);
+		TestSlot(0, INDEX_NONE, 0);
+		TestSlot(1, 10, 3, MakeAttributes(2));
+		TestSlot(2, INDEX_NONE, 0);
+
+		const FString* ClassPath = ItemClasses.Find(10);
+		TestTrue(TEXT("记录了物品类路径"), ClassPath && *ClassPath == UBaseItem::StaticClass()->GetPathName());
+		TestFalse(TEXT("没有类的物品不记录类路径"), ItemClasses.Contains(11));
+	});
+
+	It("should truncate a torn tail so that later records replay", [this]
+	{
+		TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = FInventoryJournal::Open(Name, 1);
+		Journal->RecordSet(0, 10, 3, MakeAttributes(1), nullptr);
+		Journal->RecordSet(1, 11, 2, {}, nullptr);
+		Close(Journal);
+
+		// 模拟崩溃时只写出了下一条记录的一部分
+		const FString JournalPath = FInventoryJournal::GetJournalPath(Name);
+		TArray<uint8> Bytes;
+		if (!TestTrue(TEXT("读取日志"), FFileHelper::LoadFileToArray(Bytes, *JournalPath))) return;
+		const int64 ValidSize = Bytes.Num();
+		const TArray<uint8> TornRecord(Bytes.GetData(), 9);
+		FFileHelper::SaveArrayToFile(TornRecord, *JournalPath, &IFileManager::Get(), FILEWRITE_Append);
+
+		const uint64 LastSequence = ReplayJournal();
+		TestEqual(TEXT("残缺记录之前的记录全部重放"), LastSequence, static_cast<uint64>(2));
+		TestSlot(0, 10, 3, MakeAttributes(1));
+		TestSlot(1, 11, 2);
+		TestEqual(TEXT("日志被截断到最后一条有效记录"), IFileManager::Get().FileSize(*JournalPath), ValidSize);
+		TestTrue(TEXT("原日志另存为 .corrupt"), IFileManager::Get().FileExists(*(JournalPath + TEXT(".corrupt"))));
+
+		// 截断后追加的记录与之前的记录边界对齐
+		Journal = FInventoryJournal::Open(Name, LastSequence + 1, ItemClasses);
+		Journal->RecordSet(2, 12, 5, {}, nullptr);
+		Journal->RecordClear(0);
+		Close(Journal);
+
+		TestEqual(TEXT("追加的记录被重放"), ReplayJournal(), static_cast<uint64>(4));
+		TestSlot(0, INDEX_NONE, 0);
+		TestSlot(1, 11, 2);
+		TestSlot(2, 12, 5);
+	});
+
+	It("should stop at a record whose checksum does not match", [this]
+	{
+		TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = FInventoryJournal::Open(Name, 1);
+		Journal->RecordSet(0, 10, 1, {}, nullptr);
+		Journal->RecordSet(0, 10, 2, {}, nullptr);
+		Close(Journal);
+
+		// 破坏最后一条记录的校验值
+		const FString JournalPath = FInventoryJournal::GetJournalPath(Name);
+		TArray<uint8> Bytes;
+		if (!TestTrue(TEXT("读取日志"), FFileHelper::LoadFileToArray(Bytes, *JournalPath))) return;
+		Bytes.Last() ^= 0xFF;
+		FFileHelper::SaveArrayToFile(Bytes, *JournalPath);
+
+		TestEqual(TEXT("只重放校验通过的记录"), ReplayJournal(), static_cast<uint64>(1));
+		TestSlot(0, 10, 1);
+	});
+
+	It("should restore a snapshot followed by newer records", [this]
+	{
+		TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal = FInventoryJournal::Open(Name, 1);
+		Journal->RecordSet(0, 10, 3, MakeAttributes(3), UBaseItem::StaticClass());
+		Journal->RecordSet(1, 11, 1, {}, nullptr);
+
+		TArray<FInventoryJournalSlotState> States;
+		States.SetNum(NumSlots);
+		States[0] = {10, 3, MakeAttributes(3)};
+		States[1] = {11, 1, {}};
+		Journal->WriteSnapshot(States);
+
+		Journal->RecordSet(1, 11, 4, MakeAttributes(4), nullptr);
+		const uint64 LastSequence = Journal->GetLastSequence();
+		Close(Journal);
+
+		TestTrue(TEXT("快照文件存在"), IFileManager::Get().FileExists(*FInventoryJournal::GetSnapshotPath(Name)));
+
+		TestEqual(TEXT("重放到最后一条记录"), ReplayJournal(), LastSequence);
+		TestSlot(0, 10, 3, MakeAttributes(3));
+		TestSlot(1, 11, 4, MakeAttributes(4));
+		TestTrue(TEXT("快照保存了物品类表"), ItemClasses.Contains(10));
+
+		// 只保留快照时结果相同，说明快照之前的记录已从日志中移除
+		IFileManager::Get().Delete(*FInventoryJournal::GetJournalPath(Name));
+		ReplayJournal();
+		TestSlot(0, 10, 3, MakeAttributes(3));
+		TestSlot(1, 11, 1);
+		TestTrue(TEXT("快照保存了物品类表"), ItemClasses.Contains(10));
+	});
+}
+
+#endif
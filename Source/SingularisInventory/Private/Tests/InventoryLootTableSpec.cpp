@@ -0,0 +1,115 @@
+/* =====================================================================
+ * InventoryLootTableSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryLootTable.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryLootTableSpec,
+	"SingularisInventory.LootTable",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	UInventoryLootTable* Table = nullptr;
+
+	void AddEntry(const int32 ItemID, const float Weight) const
+	{
+		FInventoryLootEntry& Entry = Table->Entries.AddDefaulted_GetRef();
+		Entry.ItemID = ItemID;
+		Entry.Weight = Weight;
+		Entry.MinQuantity = 1;
+		Entry.MaxQuantity = 3;
+	}
+END_DEFINE_SPEC(FInventoryLootTableSpec)
+
+void FInventoryLootTableSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Table = NewObject<UInventoryLootTable>();
+		Table->AddToRoot();
+		AddEntry(1, 1.0f);
+		AddEntry(2, 2.0f);
+		AddEntry(3, 3.0f);
+		AddEntry(4, 0.0f);
+		Table->EmptyWeight = 2.0f;
+		Table->Compile();
+	});
+
+	AfterEach([this]
+	{
+		Table->RemoveFromRoot();
+		Table = nullptr;
+	});
+
+	It("should sample entries in proportion to their weights", [this]
+	{
+		static constexpr int32 NumDraws = 200000;
+		TArray<FInventoryLootDrop> Drops;
+		Table->SampleDrops(NumDraws, 12345, Drops);
+		if (!TestEqual(TEXT("抽取次数"), Drops.Num(), NumDraws)) return;
+
+		// 下标 0 为空掉落，其余为物品 ID
+		int32 Counts[5] = {};
+		for (const FInventoryLootDrop& Drop : Drops)
+		{
+			if (Drop.ItemID == INDEX_NONE)
+				++Counts[0];
+			else if (TestTrue(TEXT("掉落的物品 ID 有效"), Drop.ItemID >= 1 && Drop.ItemID <= 4))
+			{
+				++Counts[Drop.ItemID];
+				TestTrue(TEXT("数量在范围内"), Drop.Quantity >= 1 && Drop.Quantity <= 3);
+			}
+		}
+
+		// 总权重 8，逐项比较频率，容差约为 5 个标准差
+		const float Expected[5] = {2.0f / 8.0f, 1.0f / 8.0f, 2.0f / 8.0f, 3.0f / 8.0f, 0.0f};
+		for (int32 i = 0; i < 5; ++i)
+		{
+			const float Frequency = static_cast<float>(Counts[i]) / NumDraws;
+			TestEqual(FString::Printf(TEXT("第 %d 列的频率"), i), Frequency, Expected[i], 0.005f);
+		}
+	});
+
+	It("should produce identical results for the same seed", [this]
+	{
+		TArray<FInventoryLootDrop> First;
+		TArray<FInventoryLootDrop> Second;
+		Table->SampleDrops(10000, 42, First);
+		Table->SampleDrops(10000, 42, Second);
+		if (!TestEqual(TEXT("抽取次数"), First.Num(), Second.Num())) return;
+
+		for (int32 i = 0; i < First.Num(); ++i)
+		{
+			if (First[i].ItemID != Second[i].ItemID || First[i].Quantity != Second[i].Quantity)
+			{
+				AddError(FString::Printf(TEXT("第 %d 次抽取结果不同"), i));
+				return;
+			}
+		}
+	});
+
+	It("should only produce empty drops when every weight is zero", [this]
+	{
+		for (FInventoryLootEntry& Entry : Table->Entries)
+			Entry.Weight = 0.0f;
+		Table->EmptyWeight = 0.0f;
+		Table->Compile();
+
+		TArray<FInventoryLootDrop> Drops;
+		Table->SampleDrops(1000, 7, Drops);
+		TestFalse(TEXT("全部为空掉落"), Drops.ContainsByPredicate([](const FInventoryLootDrop& Drop)
+		{
+			return Drop.ItemID != INDEX_NONE;
+		}));
+	});
+}
+
+#endif
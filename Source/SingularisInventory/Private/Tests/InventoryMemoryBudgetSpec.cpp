@@ -0,0 +1,205 @@
+/* =====================================================================
+ * InventoryMemoryBudgetSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventoryItemRegistry.h"
+#include "InventoryManager.h"
+#include "InventoryStressTest.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventoryMemoryBudgetSpec,
+	"SingularisInventory.MemoryBudget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	/** 紧凑物品使用的 ItemID，避开压力测试保留的区间 */
+	static constexpr int32 CompactItemID = MAX_int32 - 0x20000;
+
+	UInventoryManager* Manager = nullptr;
+	UBaseItem* CompactDefinition = nullptr;
+	TArray<UBaseItem*> Items;
+
+	UBaseItem* MakeItem(const int32 ItemID, const int32 MaxStackSize = 1)
+	{
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = ItemID;
+		Item->MaxStackSize = MaxStackSize;
+		Item->DisplayName = FText::FromString(FString::Printf(TEXT("Budget Item %d"), ItemID));
+		Items.Add(Item);
+		return Item;
+	}
+
+	static int64 ItemBytes(UBaseItem* Item)
+	{
+		return static_cast<int64>(Item->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+	}
+
+	/** 超出内联容量、溢出到堆上的实例属性 */
+	static FInventoryItemAttributes MakeSpilledAttributes()
+	{
+		FInventoryItemAttributes Attributes;
+		for (int32 i = 0; i < FInventoryItemAttributes::InlineCapacity + 4; ++i)
+			Attributes.Set(*FString::Printf(TEXT("Stat_%d"), i), i);
+		return Attributes;
+	}
+
+	void ExpectBudgetWarning()
+	{
+		AddExpectedError(TEXT("超出预算"), EAutomationExpectedErrorFlags::Contains, 0);
+	}
+END_DEFINE_SPEC(FInventoryMemoryBudgetSpec)
+
+void FInventoryMemoryBudgetSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Manager = NewObject<UInventoryManager>();
+		Manager->AddToRoot();
+		Manager->Slots.SetNum(4);
+		Manager->BudgetPolicy = EInventoryBudgetPolicy::Reject;
+
+		CompactDefinition = MakeItem(CompactItemID, 10);
+		if (UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get())
+			Registry->RegisterItemDefinition(CompactItemID, CompactDefinition);
+	});
+
+	AfterEach([this]
+	{
+		if (UInventoryItemRegistry* Registry = UInventoryItemRegistry::Get())
+			Registry->UnregisterItemDefinition(CompactItemID, CompactDefinition);
+		CompactDefinition = nullptr;
+
+		Manager->RemoveFromRoot();
+		Manager = nullptr;
+		for (UBaseItem* Item : Items)
+			Item->RemoveFromRoot();
+		Items.Reset();
+	});
+
+	Describe("Budget", [this]
+	{
+		It("should reject an instanced item that does not fit", [this]
+		{
+			UBaseItem* First = MakeItem(1);
+			UBaseItem* Second = MakeItem(2);
+			Manager->MemoryBudgetBytes = ItemBytes(First) + ItemBytes(Second) / 2;
+
+			TestTrue(TEXT("预算内的物品被添加"), Manager->TryAddItem(First));
+
+			ExpectBudgetWarning();
+			TestFalse(TEXT("超出预算的物品被拒绝"), Manager->TryAddItem(Second));
+			TestTrue(TEXT("被拒绝的物品没有占用槽位"), Manager->IsSlotEmpty(1));
+		});
+
+		It("should only log when the policy is LogOnly", [this]
+		{
+			UBaseItem* First = MakeItem(1);
+			UBaseItem* Second = MakeItem(2);
+			Manager->MemoryBudgetBytes = ItemBytes(First);
+			Manager->BudgetPolicy = EInventoryBudgetPolicy::LogOnly;
+
+			ExpectBudgetWarning();
+			TestTrue(TEXT("第一个物品被添加"), Manager->TryAddItem(First));
+			TestTrue(TEXT("仅记录日志时超出预算的物品同样被添加"), Manager->TryAddItem(Second));
+		});
+
+		It("should reject stacking once the budget is exceeded", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+
+			UBaseItem* Item = MakeItem(1);
+			Manager->MemoryBudgetBytes = ItemBytes(Item);
+
+			TestTrue(TEXT("添加物品"), Manager->TryAddItem(Item));
+			TestTrue(TEXT("添加紧凑物品"), Manager->TryAddItemByID(CompactItemID));
+			TestTrue(TEXT("堆叠不新增字节"), Manager->TryAddItemByID(CompactItemID));
+
+			Manager->MemoryBudgetBytes = ItemBytes(Item) - 1;
+			ExpectBudgetWarning();
+			TestFalse(TEXT("已超出预算时拒绝堆叠"), Manager->TryAddItemByID(CompactItemID));
+			TestEqual(TEXT("堆叠数量不变"), Manager->Slots[1].Quantity, 2);
+		});
+
+		It("should reject compact additions whose attributes spill to the heap", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+			Manager->MemoryBudgetBytes = 1;
+
+			TestTrue(TEXT("没有属性的紧凑物品不新增字节"), Manager->TryAddItemByID(CompactItemID));
+
+			ExpectBudgetWarning();
+			TestFalse(TEXT("溢出到堆上的属性被拒绝"), Manager->TryAddItemWithAttributes(CompactItemID, MakeSpilledAttributes()));
+			TestTrue(TEXT("被拒绝的物品没有占用槽位"), Manager->IsSlotEmpty(1));
+
+			for (int32 i = 0; i < FInventoryItemAttributes::InlineCapacity; ++i)
+				TestTrue(TEXT("内联容量内的属性被设置"), Manager->SetSlotAttribute(0, *FString::Printf(TEXT("Stat_%d"), i), i));
+			TestFalse(TEXT("溢出到堆上的属性被拒绝"), Manager->SetSlotAttribute(0, TEXT("Overflow"), 1));
+			TestEqual(TEXT("被拒绝的属性没有写入"), Manager->GetSlotAttribute(0, TEXT("Overflow"), -1), -1);
+		});
+
+		It("should reject batched additions once the budget is exceeded", [this]
+		{
+			if (!TestNotNull(TEXT("物品注册表"), UInventoryItemRegistry::Get())) return;
+
+			UBaseItem* Item = MakeItem(1);
+			TestTrue(TEXT("添加物品"), Manager->TryAddItem(Item));
+			Manager->MemoryBudgetBytes = ItemBytes(Item) - 1;
+
+			ExpectBudgetWarning();
+			TestEqual(TEXT("批量添加被拒绝"), Manager->TryAddItemsByID(CompactItemID, 3), 0);
+		});
+
+		It("should release budget when items are removed", [this]
+		{
+			UBaseItem* First = MakeItem(1);
+			UBaseItem* Second = MakeItem(2);
+			Manager->MemoryBudgetBytes = FMath::Max(ItemBytes(First), ItemBytes(Second));
+
+			TestTrue(TEXT("添加第一个物品"), Manager->TryAddItem(First));
+			TestTrue(TEXT("移除第一个物品"), Manager->RemoveItemByIndex(0));
+			TestTrue(TEXT("移除后的预算可以再次使用"), Manager->TryAddItem(Second));
+		});
+	});
+
+	Describe("CollectMemoryUsage", [this]
+	{
+		It("should count each instance once and skip shared definitions", [this]
+		{
+			UBaseItem* First = MakeItem(1);
+			UBaseItem* Second = MakeItem(2);
+			Manager->TryAddItem(First);
+			Manager->TryAddItem(First);
+			Manager->TryAddItem(Second);
+			const bool bHasCompactSlot = Manager->TryAddItemByID(CompactItemID);
+
+			SingularisInventory::TScratchMap<const UClass*, int64> BytesPerClass;
+			SingularisInventory::TScratchSet<const UObject*> CountedIcons;
+			const FInventoryMemoryUsage Usage = Manager->CollectMemoryUsage(BytesPerClass, CountedIcons);
+
+			const int64 ExpectedItemBytes = ItemBytes(First) + ItemBytes(Second);
+			TestEqual(TEXT("同一实例只统计一次"), Usage.ItemBytes, ExpectedItemBytes);
+			TestEqual(TEXT("按物品类统计的类别数量"), BytesPerClass.Num(), 1);
+			const int64* ClassBytes = BytesPerClass.Find(UInventoryStressItem::StaticClass());
+			TestTrue(TEXT("按物品类统计的字节数"), ClassBytes && *ClassBytes == ExpectedItemBytes);
+			TestTrue(TEXT("紧凑槽位已添加"), bHasCompactSlot);
+
+			TestTrue(TEXT("统计管理器自身"), Usage.ManagerBytes > 0);
+			TestEqual(TEXT("没有加载的图标"), Usage.IconBytes, static_cast<int64>(0));
+			TestEqual(TEXT("没有控件"), Usage.WidgetBytes, static_cast<int64>(0));
+			TestEqual(TEXT("合计"), Usage.GetTotalBytes(), Usage.ManagerBytes + Usage.ItemBytes);
+
+			const FInventoryMemoryUsage Direct = Manager->GetMemoryUsage();
+			TestEqual(TEXT("GetMemoryUsage 与 CollectMemoryUsage 一致"), Direct.GetTotalBytes(), Usage.GetTotalBytes());
+		});
+	});
+}
+
+#endif
@@ -0,0 +1,189 @@
+/* =====================================================================
+ * InventorySearchIndexSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventorySearchIndex.h"
+#include "Async/Async.h"
+#include "InventoryManager.h"
+#include "InventoryStressTest.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventorySearchIndexSpec,
+	"SingularisInventory.SearchIndex",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	static constexpr int32 NumSlots = 8;
+
+	TArray<UBaseItem*> Items;
+	TSharedPtr<FInventorySearchIndex> Index;
+	UInventoryManager* Manager = nullptr;
+
+	UBaseItem* MakeItem(const TCHAR* DisplayName)
+	{
+		UInventoryStressItem* Item = NewObject<UInventoryStressItem>();
+		Item->AddToRoot();
+		Item->ItemID = Items.Num() + 1;
+		Item->DisplayName = FText::FromString(DisplayName);
+		Items.Add(Item);
+		return Item;
+	}
+
+	void TestQuery(const TCHAR* What, const TArray<int32>& Actual, const TArray<int32>& Expected)
+	{
+		if (Actual == Expected) return;
+
+		const auto ToString = [](const int32 Value) { return FString::FromInt(Value); };
+		AddError(FString::Printf(
+			TEXT("%s：结果为 [%s]，预期为 [%s]"),
+			What,
+			*FString::JoinBy(Actual, TEXT(", "), ToString),
+			*FString::JoinBy(Expected, TEXT(", "), ToString)
+		));
+	}
+END_DEFINE_SPEC(FInventorySearchIndexSpec)
+
+void FInventorySearchIndexSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Index = MakeShared<FInventorySearchIndex>();
+		Index->Reset(NumSlots);
+		Index->UpdateSlot(0, MakeItem(TEXT("Iron Sword")));
+		Index->UpdateSlot(1, MakeItem(TEXT("  STEEL SWORD  ")));
+		Index->UpdateSlot(2, MakeItem(TEXT("Health Potion")));
+		Index->UpdateSlot(3, MakeItem(TEXT("铁剑")));
+		Index->UpdateSlot(5, MakeItem(TEXT("Iron Ore")));
+	});
+
+	AfterEach([this]
+	{
+		if (Manager)
+		{
+			Manager->RemoveFromRoot();
+			Manager = nullptr;
+		}
+		for (UBaseItem* Item : Items)
+			Item->RemoveFromRoot();
+		Items.Reset();
+		Index.Reset();
+	});
+
+	Describe("Normalize", [this]
+	{
+		It("should trim whitespace and fold case", [this]
+		{
+			TestEqual(TEXT("规范化"), FInventorySearchIndex::Normalize(TEXT("  Iron SWORD ")), FString(TEXT("iron sword")));
+			TestEqual(TEXT("空白字符串"), FInventorySearchIndex::Normalize(TEXT("   ")), FString());
+		});
+	});
+
+	Describe("Query", [this]
+	{
+		It("should match names regardless of case", [this]
+		{
+			TestQuery(TEXT("大写查询"), Index->Query(TEXT("SWORD")), {0, 1});
+			TestQuery(TEXT("混合大小写查询"), Index->Query(TEXT("sTeEl")), {1});
+		});
+
+		It("should match short queries by prefix and substring scan", [this]
+		{
+			TestQuery(TEXT("两个字符的前缀"), Index->Query(TEXT("ir")), {0, 5});
+			TestQuery(TEXT("单个字符"), Index->Query(TEXT("h")), {2});
+			TestQuery(TEXT("非拉丁字符"), Index->Query(TEXT("铁")), {3});
+		});
+
+		It("should match three-character grams anywhere in the name", [this]
+		{
+			TestQuery(TEXT("名称中间的三元组"), Index->Query(TEXT("ord")), {0, 1});
+			TestQuery(TEXT("跨越单词的查询"), Index->Query(TEXT("n sw")), {0});
+			TestQuery(TEXT("全部三元组都存在但不连续"), Index->Query(TEXT("iron sword ore")), {});
+			TestQuery(TEXT("没有对应三元组"), Index->Query(TEXT("axe")), {});
+		});
+
+		It("should return nothing for an empty query", [this]
+		{
+			TestQuery(TEXT("空查询"), Index->Query(TEXT("  ")), {});
+		});
+	});
+
+	Describe("UpdateSlot", [this]
+	{
+		It("should replace the old name of a slot", [this]
+		{
+			Index->UpdateSlot(0, MakeItem(TEXT("Wooden Shield")));
+			TestQuery(TEXT("旧名称不再命中"), Index->Query(TEXT("iron")), {5});
+			TestQuery(TEXT("新名称命中"), Index->Query(TEXT("shield")), {0});
+
+			Index->UpdateSlot(0, nullptr);
+			TestQuery(TEXT("清空后不再命中"), Index->Query(TEXT("shield")), {});
+		});
+
+		It("should grow when a slot beyond the current size is updated", [this]
+		{
+			Index->UpdateSlot(NumSlots + 4, MakeItem(TEXT("Mana Potion")));
+			TestQuery(TEXT("新槽位命中"), Index->Query(TEXT("potion")), {2, NumSlots + 4});
+		});
+	});
+
+	Describe("Inventory manager", [this]
+	{
+		BeforeEach([this]
+		{
+			Manager = NewObject<UInventoryManager>();
+			Manager->AddToRoot();
+			Manager->Slots.SetNum(NumSlots);
+			Manager->RebuildSearchIndex();
+			Manager->TryAddItem(Items[0]);
+			Manager->TryAddItem(Items[2]);
+		});
+
+		It("should update the index when slots are added, removed and swapped", [this]
+		{
+			TestQuery(TEXT("添加后命中"), Manager->SearchItems(TEXT("sword")).Get(), {0});
+
+			Manager->SwapSlots(0, 6);
+			TestQuery(TEXT("交换后命中新槽位"), Manager->SearchItems(TEXT("sword")).Get(), {6});
+			TestQuery(TEXT("交换后其他槽位不变"), Manager->SearchItems(TEXT("potion")).Get(), {1});
+
+			Manager->RemoveItemByIndex(6);
+			TestQuery(TEXT("移除后不再命中"), Manager->SearchItems(TEXT("sword")).Get(), {});
+
+			Manager->TryAddItem(Items[1]);
+			TestQuery(TEXT("再次添加后命中"), Manager->SearchItems(TEXT("sword")).Get(), {0});
+		});
+
+		LatentIt("should complete an asynchronous query off the game thread", [this](const FDoneDelegate& Done)
+		{
+			Manager->SearchItems(TEXT("POTION")).Next([this, Done](const TArray<int32>& Result)
+			{
+				// 结果在工作线程产生，回到游戏线程再校验
+				const bool bOnGameThread = IsInGameThread();
+				AsyncTask(ENamedThreads::GameThread, [this, Done, Result, bOnGameThread]
+				{
+					TestFalse(TEXT("查询在工作线程执行"), bOnGameThread);
+					TestQuery(TEXT("异步查询结果"), Result, {1});
+					Done.Execute();
+				});
+			});
+		});
+
+		It("should only treat the most recent query as current", [this]
+		{
+			FInventorySearchIndex& SearchIndex = *Index;
+			const uint32 First = SearchIndex.BeginQuery();
+			const uint32 Second = SearchIndex.BeginQuery();
+			TestFalse(TEXT("旧查询被覆盖"), SearchIndex.IsLatestQuery(First));
+			TestTrue(TEXT("最新查询有效"), SearchIndex.IsLatestQuery(Second));
+		});
+	});
+}
+
+#endif
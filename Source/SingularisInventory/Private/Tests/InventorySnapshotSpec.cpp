@@ -0,0 +1,113 @@
+/* =====================================================================
+ * InventorySnapshotSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "InventorySnapshot.h"
+#include "InventoryManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FInventorySnapshotSpec,
+	"SingularisInventory.Snapshot",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	/** 使用注册表中不存在的物品 ID，槽位只保存 ID 与数量 */
+	static constexpr int32 TestItemID = MAX_int32 - 1;
+	static constexpr int32 NumSlots = FInventorySnapshot::SlotsPerChunk * 3 + 10;
+
+	TArray<FInventorySlot> Slots;
+	TUniquePtr<FInventorySnapshotPublisher> Publisher;
+END_DEFINE_SPEC(FInventorySnapshotSpec)
+
+void FInventorySnapshotSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Slots.SetNum(NumSlots);
+		for (int32 SlotIndex = 0; SlotIndex < NumSlots; SlotIndex += 2)
+			Slots[SlotIndex].SetItemID(TestItemID, SlotIndex + 1);
+
+		Publisher = MakeUnique<FInventorySnapshotPublisher>();
+		Publisher->Publish(Slots);
+	});
+
+	AfterEach([this]
+	{
+		Publisher.Reset();
+		Slots.Reset();
+	});
+
+	It("should publish every slot on the first publish", [this]
+	{
+		const TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Snapshot = Publisher->GetLatest();
+		TestEqual(TEXT("版本"), Snapshot->GetVersion(), static_cast<uint64>(1));
+		TestEqual(TEXT("槽位数量"), Snapshot->Num(), NumSlots);
+		TestFalse(TEXT("没有待发布的变化"), Publisher->HasPendingChanges());
+
+		for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+		{
+			const FInventorySnapshotSlot& Slot = Snapshot->GetSlot(SlotIndex);
+			const int32 ExpectedQuantity = SlotIndex % 2 == 0 ? SlotIndex + 1 : 0;
+			if (!TestEqual(FString::Printf(TEXT("槽位 %d 的数量"), SlotIndex), Slot.Quantity, ExpectedQuantity)) return;
+		}
+	});
+
+	It("should share unchanged chunks and rebuild only dirty ones", [this]
+	{
+		const TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Previous = Publisher->GetLatest();
+
+		// 修改第二块中的一个槽位
+		static constexpr int32 ChangedSlot = FInventorySnapshot::SlotsPerChunk + 5;
+		Slots[ChangedSlot].SetItemID(TestItemID, 99);
+		Publisher->MarkDirty(ChangedSlot);
+		TestTrue(TEXT("存在待发布的变化"), Publisher->HasPendingChanges());
+		Publisher->Publish(Slots);
+
+		const TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Current = Publisher->GetLatest();
+		TestEqual(TEXT("版本递增"), Current->GetVersion(), Previous->GetVersion() + 1);
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(NumSlots, FInventorySnapshot::SlotsPerChunk);
+		for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+		{
+			const int32 FirstSlot = ChunkIndex * FInventorySnapshot::SlotsPerChunk;
+			const bool bShared = &Previous->GetSlot(FirstSlot) == &Current->GetSlot(FirstSlot);
+			if (ChunkIndex == ChangedSlot / FInventorySnapshot::SlotsPerChunk)
+				TestFalse(FString::Printf(TEXT("变化的块 %d 被重建"), ChunkIndex), bShared);
+			else
+				TestTrue(FString::Printf(TEXT("未变化的块 %d 被共享"), ChunkIndex), bShared);
+		}
+
+		TestEqual(TEXT("新快照看到新数量"), Current->GetSlot(ChangedSlot).Quantity, 99);
+		TestEqual(TEXT("旧快照保持旧数量"), Previous->GetSlot(ChangedSlot).Quantity, 0);
+		TestEqual(TEXT("同块的其他槽位被复制"), Current->GetSlot(ChangedSlot - 1).Quantity, ChangedSlot);
+	});
+
+	It("should not publish a new version without changes", [this]
+	{
+		const uint64 Version = Publisher->GetLatest()->GetVersion();
+		Publisher->Publish(Slots);
+		TestEqual(TEXT("版本不变"), Publisher->GetLatest()->GetVersion(), Version);
+	});
+
+	It("should rebuild every chunk when the slot count changes", [this]
+	{
+		const TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Previous = Publisher->GetLatest();
+		Slots.AddDefaulted();
+		Publisher->MarkDirty(Slots.Num() - 1);
+		Publisher->Publish(Slots);
+
+		const TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Current = Publisher->GetLatest();
+		TestEqual(TEXT("槽位数量"), Current->Num(), NumSlots + 1);
+		TestFalse(TEXT("布局变化后不共享块"), &Previous->GetSlot(0) == &Current->GetSlot(0));
+		TestEqual(TEXT("内容保持不变"), Current->GetSlot(0).Quantity, 1);
+	});
+}
+
+#endif
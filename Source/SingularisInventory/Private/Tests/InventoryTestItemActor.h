@@ -0,0 +1,35 @@
+/* =====================================================================
+ * InventoryTestItemActor.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BaseItemActor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/ConstructorHelpers.h"
+#include "InventoryTestItemActor.generated.h"
+
+/**
+ * 自动化测试使用的物品表现类，以引擎自带的立方体作为实例化掉落网格体，提升后位于掉落变换处
+ */
+UCLASS(NotBlueprintable, HideDropdown, Transient)
+class AInventoryTestItemActor : public ABaseItemActor
+{
+	GENERATED_BODY()
+
+public:
+	AInventoryTestItemActor()
+	{
+		RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+		static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeFinder(TEXT("/Engine/BasicShapes/Cube.Cube"));
+		InstancedDropMesh = CubeFinder.Object;
+	}
+};
@@ -0,0 +1,51 @@
+/* =====================================================================
+ * InventoryTestWorld.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SingularisInventory::Tests
+{
+	/**
+	 * 自动化测试使用的游戏世界
+	 *
+	 * 没有本地玩家、控制器与视口，世界子系统按游戏世界类型初始化，创建后即开始游戏。
+	 */
+	class FInventoryTestWorld
+	{
+	public:
+		FInventoryTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SingularisInventoryTestWorld"));
+			GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+		}
+
+		~FInventoryTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		UE_NONCOPYABLE(FInventoryTestWorld);
+
+		UWorld* Get() const { return World; }
+
+	private:
+		UWorld* World = nullptr;
+	};
+}
+
+#endif
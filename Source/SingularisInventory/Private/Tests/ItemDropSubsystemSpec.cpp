@@ -0,0 +1,176 @@
+/* =====================================================================
+ * ItemDropSubsystemSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "EngineUtils.h"
+#include "InventoryStressTest.h"
+#include "InventoryTestItemActor.h"
+#include "InventoryTestWorld.h"
+#include "ItemDropSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FItemDropSubsystemSpec,
+	"SingularisInventory.ItemDropSubsystem",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	TUniquePtr<SingularisInventory::Tests::FInventoryTestWorld> TestWorld;
+	UItemDropSubsystem* Subsystem = nullptr;
+	UBaseItem* Item = nullptr;
+
+	static FTransform At(const double X)
+	{
+		return FTransform(FVector(X, 0.0, 0.0));
+	}
+
+	/** 世界中所有实例化掉落网格体组件的实例总数 */
+	int32 CountRenderedInstances() const
+	{
+		int32 Count = 0;
+		for (TActorIterator<AActor> It(TestWorld->Get()); It; ++It)
+		{
+			TInlineComponentArray<UInstancedStaticMeshComponent*> Components(*It);
+			for (const UInstancedStaticMeshComponent* Component : Components)
+				Count += Component->GetInstanceCount();
+		}
+		return Count;
+	}
+
+	/** 所有实例的 X 坐标，升序 */
+	TArray<double> GetRenderedInstanceX() const
+	{
+		TArray<double> Result;
+		for (TActorIterator<AActor> It(TestWorld->Get()); It; ++It)
+		{
+			TInlineComponentArray<UInstancedStaticMeshComponent*> Components(*It);
+			for (const UInstancedStaticMeshComponent* Component : Components)
+				for (int32 i = 0; i < Component->GetInstanceCount(); ++i)
+				{
+					FTransform Transform;
+					Component->GetInstanceTransform(i, Transform, true);
+					Result.Add(Transform.GetLocation().X);
+				}
+		}
+		Result.Sort();
+		return Result;
+	}
+END_DEFINE_SPEC(FItemDropSubsystemSpec)
+
+void FItemDropSubsystemSpec::Define()
+{
+	BeforeEach([this]
+	{
+		TestWorld = MakeUnique<SingularisInventory::Tests::FInventoryTestWorld>();
+		Subsystem = TestWorld->Get()->GetSubsystem<UItemDropSubsystem>();
+
+		UInventoryStressItem* StressItem = NewObject<UInventoryStressItem>();
+		StressItem->AddToRoot();
+		StressItem->ItemID = 7;
+		StressItem->VisualActorClass = AInventoryTestItemActor::StaticClass();
+		Item = StressItem;
+	});
+
+	AfterEach([this]
+	{
+		Item->RemoveFromRoot();
+		Item = nullptr;
+		Subsystem = nullptr;
+		TestWorld.Reset();
+	});
+
+	It("renders drops as instances instead of actors", [this]
+	{
+		if (!TestNotNull(TEXT("游戏世界创建了掉落子系统"), Subsystem)) return;
+
+		for (int32 i = 0; i < 3; ++i)
+			TestNull(TEXT("实例化掉落不生成 Actor"), Subsystem->DropItem(Item, At(i * 100.0)));
+
+		TestEqual(TEXT("实例化掉落数量"), Subsystem->GetNumInstancedDrops(), 3);
+		TestEqual(TEXT("渲染实例数量"), CountRenderedInstances(), 3);
+		TestFalse(TEXT("没有生成物品表现 Actor"), static_cast<bool>(TActorIterator<AInventoryTestItemActor>(TestWorld->Get())));
+	});
+
+	It("promotes drops in radius and frees their instances", [this]
+	{
+		if (!TestNotNull(TEXT("游戏世界创建了掉落子系统"), Subsystem)) return;
+
+		Subsystem->DropItem(Item, At(0.0));
+		Subsystem->DropItem(Item, At(100.0));
+		Subsystem->DropItem(Item, At(5000.0));
+
+		TArray<ABaseItemActor*> Promoted;
+		Subsystem->PromoteDropsInRadius(FVector::ZeroVector, 200.0f, Promoted);
+
+		TestEqual(TEXT("提升半径内的两个掉落"), Promoted.Num(), 2);
+		for (const ABaseItemActor* ItemActor : Promoted)
+		{
+			TestEqual(TEXT("提升的 Actor 持有掉落的物品"), ItemActor->Item, Item);
+			TestEqual(TEXT("提升的 Actor 携带掉落标识"), ItemActor->DropKey, UItemDropSubsystem::MakeDropKey(Item->ItemID, ItemActor->GetActorLocation()));
+		}
+
+		// 提升后实例从组件中移除，剩下的实例保持原来的位置
+		TestEqual(TEXT("剩余实例化掉落"), Subsystem->GetNumInstancedDrops(), 1);
+		TestEqual(TEXT("剩余实例位置"), GetRenderedInstanceX(), TArray<double>{5000.0});
+	});
+
+	It("keeps instances contiguous when drops are reused", [this]
+	{
+		if (!TestNotNull(TEXT("游戏世界创建了掉落子系统"), Subsystem)) return;
+
+		Subsystem->DropItem(Item, At(0.0));
+		Subsystem->DropItem(Item, At(1000.0));
+		Subsystem->DropItem(Item, At(2000.0));
+
+		// 提升第一个实例，最后一个实例移入空出的索引
+		TArray<ABaseItemActor*> Promoted;
+		Subsystem->PromoteDropsInRadius(FVector::ZeroVector, 10.0f, Promoted);
+		TestEqual(TEXT("提升一个掉落"), Promoted.Num(), 1);
+		TestEqual(TEXT("移除后的实例位置"), GetRenderedInstanceX(), TArray<double>{1000.0, 2000.0});
+
+		// 新掉落复用空出的句柄，实例追加在末尾
+		Subsystem->DropItem(Item, At(3000.0));
+		TestEqual(TEXT("复用后的实例化掉落"), Subsystem->GetNumInstancedDrops(), 3);
+		TestEqual(TEXT("复用后的实例位置"), GetRenderedInstanceX(), TArray<double>{1000.0, 2000.0, 3000.0});
+
+		// 被移动过索引的实例仍能被正确提升
+		Subsystem->PromoteDropsInRadius(FVector(2000.0, 0.0, 0.0), 10.0f, Promoted);
+		TestEqual(TEXT("提升移动过索引的掉落"), Promoted.Num(), 1);
+		TestEqual(TEXT("最终实例位置"), GetRenderedInstanceX(), TArray<double>{1000.0, 3000.0});
+
+		Subsystem->PromoteDropsInRadius(FVector::ZeroVector, 10000.0f, Promoted);
+		TestEqual(TEXT("全部提升后没有实例"), CountRenderedInstances(), 0);
+		TestEqual(TEXT("全部提升后没有实例化掉落"), Subsystem->GetNumInstancedDrops(), 0);
+	});
+
+	It("releases the drop whose key matches a replicated actor", [this]
+	{
+		if (!TestNotNull(TEXT("游戏世界创建了掉落子系统"), Subsystem)) return;
+
+		Subsystem->DropItem(Item, At(0.0));
+		Subsystem->DropItem(Item, At(30.0));
+
+		// 模拟复制到达的 Actor：位置靠近第一个掉落，但标识属于第二个掉落
+		ABaseItemActor* Replicated = TestWorld->Get()->SpawnActorDeferred<ABaseItemActor>(AInventoryTestItemActor::StaticClass(), At(1.0));
+		Replicated->Item = Item;
+		Replicated->DropKey = UItemDropSubsystem::MakeDropKey(Item->ItemID, FVector(30.0, 0.0, 0.0));
+		Replicated->FinishSpawning(At(1.0));
+
+		Subsystem->ReleaseReplicatedDrop(Replicated);
+		TestEqual(TEXT("只移除标识匹配的掉落"), GetRenderedInstanceX(), TArray<double>{0.0});
+
+		// 不是提升而来的 Actor 不会移除任何掉落
+		Replicated->DropKey = 0;
+		Subsystem->ReleaseReplicatedDrop(Replicated);
+		TestEqual(TEXT("没有标识时不移除"), Subsystem->GetNumInstancedDrops(), 1);
+	});
+}
+
+#endif
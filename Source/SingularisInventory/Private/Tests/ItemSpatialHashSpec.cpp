@@ -0,0 +1,146 @@
+/* =====================================================================
+ * ItemSpatialHashSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "ItemSpatialHash.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(
+	FItemSpatialHashSpec,
+	"SingularisInventory.SpatialHash",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+	static constexpr float WorldExtent = 5000.0f;
+
+	FRandomStream Random;
+	TUniquePtr<FItemSpatialHash> Hash;
+
+	/** 与空间哈希同步维护的条目，作为暴力查找的参照 */
+	TMap<int32, FVector> Points;
+
+	FVector RandomLocation() const
+	{
+		return FVector(
+			Random.FRandRange(-WorldExtent, WorldExtent),
+			Random.FRandRange(-WorldExtent, WorldExtent),
+			Random.FRandRange(-200.0f, 200.0f)
+		);
+	}
+
+	/** 随机查询若干次，比较空间哈希与暴力查找得到的最近距离 */
+	void TestFindNearestMatchesBruteForce(const float MaxRadius)
+	{
+		const float MaxRadiusSquared = FMath::Square(MaxRadius);
+		for (int32 Query = 0; Query < 500; ++Query)
+		{
+			const FVector Center = RandomLocation();
+
+			int32 Expected = INDEX_NONE;
+			float ExpectedDistanceSquared = MaxRadiusSquared;
+			for (const TPair<int32, FVector>& Point : Points)
+			{
+				const float DistanceSquared = FVector::DistSquared(Center, Point.Value);
+				if (DistanceSquared <= ExpectedDistanceSquared)
+				{
+					Expected = Point.Key;
+					ExpectedDistanceSquared = DistanceSquared;
+				}
+			}
+
+			float DistanceSquared = 0.0f;
+			const int32 Found = Hash->FindNearest(Center, MaxRadius, &DistanceSquared);
+			if (Expected == INDEX_NONE)
+			{
+				if (!TestEqual(TEXT("半径内没有条目时返回 INDEX_NONE"), Found, INDEX_NONE)) return;
+				continue;
+			}
+
+			// 距离相同的条目可能有多个，只比较距离
+			if (!TestTrue(TEXT("找到有效条目"), Found != INDEX_NONE && Points.Contains(Found))) return;
+			if (!TestEqual(TEXT("最近距离与暴力查找一致"), DistanceSquared, ExpectedDistanceSquared, 1.0f)) return;
+			if (!TestEqual(TEXT("返回的距离与条目位置一致"), FVector::DistSquared(Center, Points[Found]), DistanceSquared, 1.0f)) return;
+		}
+	}
+END_DEFINE_SPEC(FItemSpatialHashSpec)
+
+void FItemSpatialHashSpec::Define()
+{
+	BeforeEach([this]
+	{
+		Random.Initialize(2024);
+		Hash = MakeUnique<FItemSpatialHash>(250.0f);
+		Points.Reset();
+
+		for (int32 i = 0; i < 2000; ++i)
+		{
+			const FVector Location = RandomLocation();
+			Points.Add(Hash->Add(Location), Location);
+		}
+	});
+
+	AfterEach([this]
+	{
+		Hash.Reset();
+		Points.Reset();
+	});
+
+	It("should find the same nearest distance as a brute force search", [this]
+	{
+		TestEqual(TEXT("条目数量"), Hash->Num(), Points.Num());
+		TestFindNearestMatchesBruteForce(400.0f);
+		TestFindNearestMatchesBruteForce(3000.0f);
+	});
+
+	It("should stay consistent after entries are removed and moved", [this]
+	{
+		TArray<int32> Handles;
+		Points.GenerateKeyArray(Handles);
+
+		for (int32 i = 0; i < Handles.Num(); ++i)
+		{
+			const int32 Handle = Handles[i];
+			if (i % 3 == 0)
+			{
+				Hash->Remove(Handle);
+				Points.Remove(Handle);
+			}
+			else if (i % 3 == 1)
+			{
+				// 一半留在原网格附近，一半移动到任意位置
+				const FVector Location = i % 2 == 0
+					                         ? Points[Handle] + FVector(Random.FRandRange(-50.0f, 50.0f), Random.FRandRange(-50.0f, 50.0f), 0.0f)
+					                         : RandomLocation();
+				Hash->Update(Handle, Location);
+				Points[Handle] = Location;
+			}
+		}
+
+		// 被移除的句柄可能被复用
+		for (int32 i = 0; i < 100; ++i)
+		{
+			const FVector Location = RandomLocation();
+			const int32 Handle = Hash->Add(Location);
+			if (!TestFalse(TEXT("新句柄不与有效条目冲突"), Points.Contains(Handle))) return;
+			Points.Add(Handle, Location);
+		}
+
+		TestEqual(TEXT("条目数量"), Hash->Num(), Points.Num());
+		for (const TPair<int32, FVector>& Point : Points)
+		{
+			if (!TestTrue(TEXT("句柄有效"), Hash->IsValidHandle(Point.Key))) return;
+			if (!TestEqual(TEXT("位置已更新"), Hash->GetLocation(Point.Key), Point.Value)) return;
+		}
+
+		TestFindNearestMatchesBruteForce(400.0f);
+		TestFindNearestMatchesBruteForce(3000.0f);
+	});
+}
+
+#endif
@@ -21,6 +21,45 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
 	PlayerController
 );
 
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FItemStatModifier
+{
+	GENERATED_BODY()
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "物品属性修正",
+		meta = (
+			DisplayName = "属性名称",
+			ToolTip = "被修正的属性名称，例如 Attack、Defense"
+		)
+	)
+	FName StatName;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "物品属性修正",
+		meta = (
+			DisplayName = "加值",
+			ToolTip = "直接加到属性基础值上的数值"
+		)
+	)
+	float Additive = 0.0f;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "物品属性修正",
+		meta = (
+			DisplayName = "百分比加成",
+			ToolTip = "按比例提升属性，0.1 表示提升 10%，多个加成相加后统一结算"
+		)
+	)
+	float Multiplier = 0.0f;
+};
+
 /**
  * 基本物品类
  */
@@ -117,6 +156,58 @@ public:
 	)
 	bool bAccessory = false;
 
+	UPROPERTY(
+		EditDefaultsOnly,
+		BlueprintReadOnly,
+		Category = "物品|用途属性",
+		meta = (
+			DisplayName = "最大堆叠数量",
+			ToolTip = "同一槽位最多可以堆叠的该物品数量。只有紧凑存储的槽位会堆叠，实例存储的每个物品实例独占一个槽位；默认为 1，即不堆叠",
+			ClampMin = "1"
+		)
+	)
+	int32 MaxStackSize = 1;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "物品|用途属性",
+		meta = (
+			DisplayName = "使用冷却",
+			ToolTip = "使用该物品后，同 ID 的物品需要等待的秒数，0 表示没有冷却",
+			ClampMin = "0"
+		)
+	)
+	float UseCooldown = 0.0f;
+
+#pragma endregion
+
+#pragma region 物品佩戴属性
+
+	UPROPERTY(
+		EditDefaultsOnly,
+		BlueprintReadOnly,
+		Category = "物品|佩戴属性",
+		meta = (
+			DisplayName = "装备槽位类型",
+			ToolTip = "可佩戴物品能够放入的装备槽位类型，例如 Head、Ring，需与装备组件中的槽位类型一致",
+			EditCondition = "bAccessory"
+		)
+	)
+	FName EquipmentSlotType;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "物品|佩戴属性",
+		meta = (
+			DisplayName = "属性修正",
+			ToolTip = "佩戴该物品时提供的属性修正",
+			EditCondition = "bAccessory"
+		)
+	)
+	TArray<FItemStatModifier> StatModifiers;
+
 #pragma endregion
 
 #pragma region 物品委托
@@ -132,4 +223,6 @@ public:
 	FOnItemUseDelegate OnItemUse{};
 
 #pragma endregion
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 };
@@ -14,6 +14,7 @@
 #include "BaseItemActor.generated.h"
 
 class UBaseItem;
+class UStaticMesh;
 
 /**
  * 基本物品表现类
@@ -34,11 +35,35 @@ public:
 	UBaseItem* Item = nullptr;
 #pragma endregion
 
+#pragma region 掉落表现属性
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintReadOnly,
+		Category="物品属性|掉落表现",
+		meta=(DisplayName = "实例化掉落网格体",
+			ToolTip = "设置后，该表现类的掉落物品会先以共享的实例化静态网格体渲染，玩家靠近或交互时才生成完整的物品表现 Actor。为空则直接生成 Actor。"
+		))
+	UStaticMesh* InstancedDropMesh = nullptr;
+
+	/** 由实例掉落提升而来时的掉落标识，复制到客户端后用于移除对应的本地实例，0 表示不是提升而来 */
+	UPROPERTY(Replicated)
+	uint32 DropKey = 0;
+#pragma endregion
+
 	ABaseItemActor();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void Tick(float DeltaTime) override;
+
+private:
+	/** 在 UItemSpatialSubsystem 中的空间句柄 */
+	int32 SpatialHandle = INDEX_NONE;
+
+	/** 上次同步到空间索引的位置 */
+	FVector LastSpatialLocation = FVector::ZeroVector;
 };
@@ -0,0 +1,54 @@
+/* =====================================================================
+ * InventoryCooldownWheel.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 冷却时间轮
+ *
+ * 所有冷却共享一个按固定刻度推进的时间轮，而不是为每个物品注册独立的定时器。
+ * 查询是否处于冷却为 O(1)，每次推进只处理到期刻度所在的桶。
+ */
+class SINGULARISINVENTORY_API FInventoryCooldownWheel
+{
+public:
+	explicit FInventoryCooldownWheel(float InTickSeconds = 0.05f, int32 InNumBuckets = 256);
+
+	/** 开始或刷新指定键的冷却，到期刻度按开始时刻（含未满一个刻度的部分）向上取整 */
+	void Start(int32 Key, float Seconds);
+
+	/** 指定键是否处于冷却中 */
+	bool IsCoolingDown(const int32 Key) const
+	{
+		const uint64* ExpireTick = Active.Find(Key);
+		return ExpireTick && *ExpireTick > CurrentTick;
+	}
+
+	/** 剩余冷却秒数，不在冷却中时返回 0 */
+	float GetRemaining(int32 Key) const;
+
+	/** 推进时间轮并清理到期的冷却 */
+	void Advance(float DeltaTime);
+
+	/** 是否存在任何冷却 */
+	bool IsEmpty() const { return Active.IsEmpty(); }
+
+private:
+	float TickSeconds;
+	uint64 CurrentTick = 0;
+	float Accumulator = 0.0f;
+
+	/** 键 -> 到期刻度 */
+	TMap<int32, uint64> Active;
+
+	/** 刻度取模后的桶，桶中可能残留已被刷新的旧条目，处理时以 Active 为准 */
+	TArray<TArray<int32>> Buckets;
+};
@@ -0,0 +1,168 @@
+/* =====================================================================
+ * InventoryCraftingSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryRecipeBook.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "InventoryCraftingSubsystem.generated.h"
+
+class UInventoryManager;
+
+/**
+ * 合成子系统
+ *
+ * 注册的配方按 ItemID 编译为材料 -> 配方的反向索引。被跟踪的库存各自维护物品数量、
+ * 每个配方已满足的材料条目数与可合成配方集合；槽位变化时只重新检查用到该物品的配方，
+ * 因此查询可合成配方不需要遍历配方或槽位。
+ */
+UCLASS()
+class SINGULARISINVENTORY_API UInventoryCraftingSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 获取合成子系统实例，引擎尚未初始化时返回 nullptr */
+	static UInventoryCraftingSubsystem* Get();
+
+	virtual void Deinitialize() override;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "注册配方集",
+			ToolTip = "把配方集中的配方加入索引，已跟踪的库存会重新统计"
+		)
+	)
+	void RegisterRecipeBook(UInventoryRecipeBook* RecipeBook);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "获取配方",
+			ToolTip = "通过配方索引获取配方"
+		)
+	)
+	FInventoryRecipe GetRecipe(int32 RecipeIndex) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "查找配方",
+			ToolTip = "通过配方名称查找配方索引，找不到时返回 -1"
+		)
+	)
+	int32 FindRecipe(FName RecipeName) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "获取使用该物品的配方",
+			ToolTip = "获取以指定物品为材料的所有配方索引"
+		)
+	)
+	void GetRecipesUsingItem(int32 ItemID, TArray<int32>& OutRecipeIndices) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "获取可合成配方",
+			ToolTip = "获取库存当前材料足够的所有配方索引，库存尚未被跟踪时会先建立跟踪"
+		)
+	)
+	void GetCraftableRecipes(UInventoryManager* Inventory, TArray<int32>& OutRecipeIndices);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "配方是否可合成",
+			ToolTip = "库存当前的材料是否足够合成该配方"
+		)
+	)
+	bool IsRecipeCraftable(UInventoryManager* Inventory, int32 RecipeIndex);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="合成子系统",
+		meta = (
+			DisplayName = "合成",
+			ToolTip = "消耗材料并把产物放入库存，材料不足或产物放不下时失败且不改变库存"
+		)
+	)
+	bool Craft(UInventoryManager* Inventory, int32 RecipeIndex);
+
+	/** 开始跟踪库存的可合成配方，已跟踪时不做任何事 */
+	void TrackInventory(UInventoryManager* Inventory);
+
+	/** 停止跟踪库存 */
+	void UntrackInventory(UInventoryManager* Inventory);
+
+	/** 库存中指定物品的数量，库存尚未被跟踪时会先建立跟踪 */
+	int32 GetItemCount(UInventoryManager* Inventory, int32 ItemID);
+
+	int32 NumRecipes() const { return Recipes.Num(); }
+
+private:
+	/** 反向索引条目：某个配方需要该物品的数量 */
+	struct FIngredientUse
+	{
+		int32 RecipeIndex;
+		int32 Quantity;
+	};
+
+	/** 单个库存的增量合成状态 */
+	struct FCraftingTracker
+	{
+		TWeakObjectPtr<UInventoryManager> Inventory;
+		FDelegateHandle SlotChangedHandle;
+
+		/** 上次观察到的槽位内容，用于计算槽位变化前后的数量差 */
+		TArray<int32> SlotItemIDs;
+		TArray<int32> SlotQuantities;
+
+		/** ItemID -> 库存中的总数量 */
+		TMap<int32, int32> ItemCounts;
+
+		/** 每个配方已满足的材料条目数，等于材料条目总数时可合成 */
+		TArray<int32> SatisfiedIngredients;
+		TBitArray<> Craftable;
+	};
+
+	FCraftingTracker* FindOrAddTracker(UInventoryManager* Inventory);
+
+	/** 按库存当前内容重新统计 */
+	void RebuildTracker(FCraftingTracker& Tracker) const;
+
+	void HandleSlotChanged(UInventoryManager* Inventory, int32 SlotIndex);
+
+	/** 调整物品数量，并重新检查以该物品为材料的配方 */
+	void ApplyItemDelta(FCraftingTracker& Tracker, int32 ItemID, int32 Delta) const;
+
+	/** 编译后的配方，每个配方中的同一材料已合并为一个条目 */
+	TArray<FInventoryRecipe> Recipes;
+
+	/** 材料 ItemID -> 使用该材料的配方 */
+	TMap<int32, TArray<FIngredientUse>> IngredientIndex;
+
+	TMap<FName, int32> RecipesByName;
+
+	TMap<TObjectKey<UInventoryManager>, FCraftingTracker> Trackers;
+
+	UPROPERTY(Transient)
+	TArray<UInventoryRecipeBook*> RecipeBooks;
+};
@@ -0,0 +1,192 @@
+/* =====================================================================
+ * InventoryEquipment.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InventoryItemAttributes.h"
+#include "InventoryEquipment.generated.h"
+
+class UBaseItem;
+class UInventoryManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+	FOnEquipmentChangedDelegate,
+	int32,
+	EquipmentSlotIndex
+);
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryEquipmentSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "装备槽位",
+		meta = (
+			DisplayName = "槽位类型",
+			ToolTip = "该装备槽位接受的物品类型，与物品的装备槽位类型对应"
+		)
+	)
+	FName SlotType;
+
+	UPROPERTY(
+		BlueprintReadOnly,
+		Category = "装备槽位",
+		meta = (
+			DisplayName = "装备物品",
+			ToolTip = "当前佩戴的物品"
+		)
+	)
+	UBaseItem* Item = nullptr;
+
+	UPROPERTY(
+		BlueprintReadOnly,
+		Category = "装备槽位",
+		meta = (
+			DisplayName = "实例属性",
+			ToolTip = "佩戴物品在库存槽位中的实例属性，卸下时随物品一起放回库存"
+		)
+	)
+	FInventoryItemAttributes Attributes;
+};
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FEquipmentStatTotal
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "装备属性", meta = (DisplayName = "加值合计"))
+	float Additive = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "装备属性", meta = (DisplayName = "百分比加成合计"))
+	float Multiplier = 0.0f;
+
+	/** 提供该属性修正的装备数量，归零时移除条目以消除浮点累积误差 */
+	int32 Contributors = 0;
+};
+
+/**
+ * 装备组件
+ *
+ * 与同一 Actor 上的库存管理器配合使用，提供按类型划分的装备槽位。
+ * 所有已佩戴物品的属性修正汇总缓存在组件中，并在穿戴与卸下时增量更新，查询属性为 O(1)。
+ */
+UCLASS(Blueprintable, ClassGroup=("引力奇点库存系统"), meta=(BlueprintSpawnableComponent))
+class SINGULARISINVENTORY_API UInventoryEquipment : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+#pragma region 装备组件属性
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category="装备组件|属性",
+		meta = (
+			DisplayName = "装备槽位",
+			ToolTip = "装备槽位列表，每个槽位只接受对应类型的可佩戴物品"
+		)
+	)
+	TArray<FInventoryEquipmentSlot> EquipmentSlots;
+
+#pragma endregion
+
+#pragma region 装备组件委托
+
+	UPROPERTY(
+		BlueprintAssignable,
+		Category = "装备组件|委托",
+		meta = (
+			DisplayName = "装备变化时触发",
+			ToolTip = "当装备槽位的物品变化时触发的事件。"
+		)
+	)
+	FOnEquipmentChangedDelegate OnEquipmentChanged;
+
+#pragma endregion
+
+	UInventoryEquipment();
+
+protected:
+	virtual void BeginPlay() override;
+
+public:
+#pragma region 装备组件操作函数
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="装备组件|操作函数",
+		meta = (
+			DisplayName = "佩戴物品",
+			ToolTip = "把库存槽位中的可佩戴物品放入装备槽位。装备槽位索引为 -1 时自动选择第一个同类型槽位，已有装备会被放回库存"
+		)
+	)
+	bool Equip(int32 InventorySlotIndex, int32 EquipmentSlotIndex = -1);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="装备组件|操作函数",
+		meta = (
+			DisplayName = "卸下物品",
+			ToolTip = "把装备槽位中的物品放回库存，库存已满时失败"
+		)
+	)
+	bool Unequip(int32 EquipmentSlotIndex);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="装备组件|操作函数",
+		meta = (
+			DisplayName = "获取装备属性修正",
+			ToolTip = "获取所有已佩戴物品对指定属性的修正合计"
+		)
+	)
+	FEquipmentStatTotal GetStatTotal(FName StatName) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="装备组件|操作函数",
+		meta = (
+			DisplayName = "计算装备后的属性",
+			ToolTip = "按 (基础值 + 加值合计) * (1 + 百分比加成合计) 计算属性"
+		)
+	)
+	float ApplyStat(FName StatName, float BaseValue) const;
+
+	/** 获取属性修正合计，未被任何装备修正时返回 nullptr */
+	const FEquipmentStatTotal* FindStatTotal(const FName StatName) const
+	{
+		return StatTotals.Find(StatName);
+	}
+
+#pragma endregion
+
+private:
+	/** 把物品的属性修正计入或移出缓存 */
+	void ApplyModifiers(const UBaseItem* Item, float Sign);
+
+	/** 查找接受该物品的装备槽位，优先空槽位 */
+	int32 FindEquipmentSlotFor(const UBaseItem* Item) const;
+
+	/** 把物品连同实例属性放回库存，紧凑存储的共享定义按 ItemID 放回 */
+	bool ReturnToInventory(UBaseItem* Item, const FInventoryItemAttributes& Attributes) const;
+
+	UPROPERTY(Transient)
+	UInventoryManager* Inventory = nullptr;
+
+	/** 属性名称 -> 修正合计 */
+	TMap<FName, FEquipmentStatTotal> StatTotals;
+};
@@ -0,0 +1,102 @@
+/* =====================================================================
+ * InventoryGridStyle.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Fonts/SlateFontInfo.h"
+#include "Layout/Margin.h"
+#include "Styling/SlateBrush.h"
+#include "Styling/CoreStyle.h"
+#include "Styling/SlateColor.h"
+#include "InventoryGridStyle.generated.h"
+
+/** 原生槽位网格的外观 */
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryGridStyle
+{
+	GENERATED_BODY()
+
+	FInventoryGridStyle()
+	{
+		SlotBrush.TintColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.5f);
+		SelectedSlotBrush.TintColor = FLinearColor(1.0f, 0.8f, 0.2f, 0.6f);
+		QuantityFont = FCoreStyle::GetDefaultFontStyle("Bold", 10);
+	}
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "槽位背景"
+		)
+	)
+	FSlateBrush SlotBrush;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "选中槽位背景"
+		)
+	)
+	FSlateBrush SelectedSlotBrush;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "槽位大小"
+		)
+	)
+	FVector2D SlotSize = FVector2D(64.0f, 64.0f);
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "槽位间距"
+		)
+	)
+	FMargin SlotPadding = FMargin(2.0f);
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "图标内边距"
+		)
+	)
+	FMargin IconPadding = FMargin(6.0f);
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "数量字体"
+		)
+	)
+	FSlateFontInfo QuantityFont;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category = "槽位网格样式",
+		meta = (
+			DisplayName = "数量颜色"
+		)
+	)
+	FSlateColor QuantityColor = FSlateColor(FLinearColor::White);
+};
@@ -0,0 +1,87 @@
+/* =====================================================================
+ * InventoryGridWidget.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "InventoryGridStyle.h"
+#include "InventoryGridWidget.generated.h"
+
+class SInventoryGrid;
+class UInventoryManager;
+
+/**
+ * 原生库存槽位网格的 UMG 包装
+ *
+ * 可以直接放入任意控件蓝图中，由设计师调整列数与样式；槽位的绘制与刷新完全在 Slate 中完成。
+ */
+UCLASS(meta = (DisplayName = "库存槽位网格"))
+class SINGULARISINVENTORY_API UInventoryGridWidget : public UWidget
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "库存槽位网格",
+		meta = (
+			DisplayName = "列数",
+			ClampMin = "1"
+		)
+	)
+	int32 Columns = 10;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "库存槽位网格",
+		meta = (
+			DisplayName = "样式"
+		)
+	)
+	FInventoryGridStyle Style;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存槽位网格",
+		meta = (
+			DisplayName = "设置库存",
+			ToolTip = "设置网格显示的库存管理器"
+		)
+	)
+	void SetInventory(UInventoryManager* InInventory);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="库存槽位网格",
+		meta = (
+			DisplayName = "获取库存"
+		)
+	)
+	UInventoryManager* GetInventory() const { return Inventory.Get(); }
+
+	virtual void SynchronizeProperties() override;
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UInventoryManager> Inventory;
+
+	TSharedPtr<SInventoryGrid> MyGrid;
+};
@@ -0,0 +1,106 @@
+/* =====================================================================
+ * InventoryItemAttributes.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryItemAttributes.generated.h"
+
+/**
+ * 物品实例属性
+ *
+ * 以名称为键的整数属性（耐久、充能、附魔 ID 等），直接存放在库存槽位中。
+ * 少量属性保存在内联缓冲区中，不产生堆分配，也不需要为每个物品实例创建 UObject。
+ * 条目按键排序并缓存哈希，比较两份属性时先比较哈希，属性完全相同的物品仍然可以堆叠。
+ */
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryItemAttributes
+{
+	GENERATED_BODY()
+
+	/** 超过该数量的属性才会分配堆内存 */
+	static constexpr int32 InlineCapacity = 4;
+
+	struct FEntry
+	{
+		FName Key;
+		int32 Value = 0;
+
+		bool operator==(const FEntry& Other) const
+		{
+			return Key == Other.Key && Value == Other.Value;
+		}
+	};
+
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+	int32 Num() const { return Entries.Num(); }
+
+	/** 查找属性，不存在时返回 nullptr */
+	const int32* Find(FName Key) const;
+
+	int32 Get(const FName Key, const int32 DefaultValue = 0) const
+	{
+		const int32* Value = Find(Key);
+		return Value ? *Value : DefaultValue;
+	}
+
+	/** 设置属性，不存在时按键序插入 */
+	void Set(FName Key, int32 Value);
+
+	/** 移除属性，返回是否存在 */
+	bool Remove(FName Key);
+
+	void Reset();
+
+	TConstArrayView<FEntry> GetEntries() const { return Entries; }
+
+	/** 超出内联缓冲区后占用的堆内存 */
+	SIZE_T GetAllocatedSize() const { return Entries.GetAllocatedSize(); }
+
+	bool operator==(const FInventoryItemAttributes& Other) const
+	{
+		return Hash == Other.Hash && Entries == Other.Entries;
+	}
+
+	bool operator!=(const FInventoryItemAttributes& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	friend uint32 GetTypeHash(const FInventoryItemAttributes& Attributes)
+	{
+		return Attributes.Hash;
+	}
+
+	bool Serialize(FArchive& Ar);
+	bool Identical(const FInventoryItemAttributes* Other, uint32 PortFlags) const;
+
+	/** 不含任何属性的共享实例 */
+	static const FInventoryItemAttributes Empty;
+
+private:
+	void UpdateHash();
+
+	int32 LowerBound(FName Key) const;
+
+	/** 按 FName::FastLess 排序，保证相同的属性集合有唯一的内存表示 */
+	TArray<FEntry, TInlineAllocator<InlineCapacity>> Entries;
+
+	uint32 Hash = 0;
+};
+
+template <>
+struct TStructOpsTypeTraits<FInventoryItemAttributes> : TStructOpsTypeTraitsBase2<FInventoryItemAttributes>
+{
+	enum
+	{
+		WithSerializer = true,
+		WithIdentical = true,
+	};
+};
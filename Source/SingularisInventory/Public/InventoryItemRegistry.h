@@ -0,0 +1,79 @@
+/* =====================================================================
+ * InventoryItemRegistry.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "InventoryItemRegistry.generated.h"
+
+class UBaseItem;
+
+/**
+ * 物品定义注册表
+ *
+ * 维护 ItemID -> 物品定义对象的映射。紧凑存储的库存槽位只记录 ItemID，
+ * 由注册表统一持有定义对象，槽位本身不再引用任何物品实例。
+ *
+ * 定义对象由注册表创建并持有（不是类默认对象），被所有同 ItemID 的紧凑槽位共享，
+ * 注册后应视为只读：修改其属性或绑定其 OnItemUse 会作用于所有共享该定义的槽位。
+ */
+UCLASS()
+class SINGULARISINVENTORY_API UInventoryItemRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 获取注册表实例，引擎尚未初始化时返回 nullptr */
+	static UInventoryItemRegistry* Get();
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品注册表",
+		meta = (
+			DisplayName = "注册物品类",
+			ToolTip = "以物品类默认对象的 ItemID 注册物品定义，注册表会为该类创建一个独立的只读定义对象"
+		)
+	)
+	bool RegisterItemClass(TSubclassOf<UBaseItem> ItemClass);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品注册表",
+		meta = (
+			DisplayName = "注册物品定义",
+			ToolTip = "以指定 ItemID 注册物品定义对象，注册表会持有该对象，注册后不应再修改。传入类默认对象时会改为创建独立的定义对象"
+		)
+	)
+	bool RegisterItemDefinition(int32 ItemID, UBaseItem* Definition);
+
+	/** 注销物品定义，仅当当前注册的正是 ExpectedDefinition 时才移除，避免误删他人的注册 */
+	bool UnregisterItemDefinition(int32 ItemID, const UBaseItem* ExpectedDefinition);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="物品注册表",
+		meta = (
+			DisplayName = "查找物品定义",
+			ToolTip = "通过 ItemID 查找物品定义，该对象被所有紧凑存储的同类物品共享，应视为只读"
+		)
+	)
+	UBaseItem* FindItemDefinition(int32 ItemID) const;
+
+	/** 已注册的物品定义数量 */
+	int32 Num() const { return Definitions.Num(); }
+
+private:
+	/** 为物品类创建注册表持有的定义对象 */
+	UBaseItem* CreateDefinition(TSubclassOf<UBaseItem> ItemClass);
+
+	UPROPERTY(Transient)
+	TMap<int32, UBaseItem*> Definitions;
+};
@@ -0,0 +1,158 @@
+/* =====================================================================
+ * InventoryJournal.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryItemAttributes.h"
+
+class FInventoryJournalWriter;
+
+/** 日志记录的操作类型 */
+enum class EInventoryJournalOp : uint8
+{
+	/** 槽位被设置为记录中的物品与数量（添加、堆叠、部分移除） */
+	Set,
+
+	/** 槽位被清空 */
+	Clear,
+
+	/** 交换两个槽位 */
+	Swap,
+
+	/** 声明 ItemID 对应的物品类路径，恢复时即使注册表中没有该 ItemID 也能重新加载物品类 */
+	DefineItem
+};
+
+/** 重放得到的单个槽位状态 */
+struct FInventoryJournalSlotState
+{
+	int32 ItemID = INDEX_NONE;
+	int32 Quantity = 0;
+	FInventoryItemAttributes Attributes;
+
+	friend FArchive& operator<<(FArchive& Ar, FInventoryJournalSlotState& State)
+	{
+		Ar << State.ItemID << State.Quantity;
+		State.Attributes.Serialize(Ar);
+		return Ar;
+	}
+};
+
+/**
+ * 库存预写操作日志
+ *
+ * 游戏线程把记录编码后追加到内存缓冲区；进程内所有日志共用一个后台写入线程，
+ * 定期取走各日志积累的记录，追加到各自的本地文件后统一刷新。
+ * 写入快照时先写出快照文件，再清空日志文件，之后的记录从新的日志开始。
+ *
+ * 每条记录的格式为 [负载长度][负载][负载 CRC]，Set 与 Clear 记录的是操作后的槽位状态（含实例属性）而不是增量，
+ * 重放同一条记录多次结果相同，因此快照与日志之间的重叠不会造成重复计数。
+ * 每个 ItemID 第一次写入时先写一条 DefineItem 记录保存物品类路径，快照同样保存完整的类表。
+ *
+ * 启动时先读取快照，再按序号重放快照之后的日志记录，遇到不完整或校验失败的记录即停止，
+ * 并把日志文件截断到最后一条有效记录的边界（原文件另存为 .corrupt），之后追加的记录才能被正确重放。
+ *
+ * 日志只记录槽位层面的状态（ItemID、数量、实例属性）与物品类路径，不序列化物品实例对象自身的属性。
+ * 紧凑存储的槽位本来就只有这些状态，可以无损恢复；实例存储的物品恢复后成为注册表中共享的物品定义，
+ * 运行时修改过的实例 UPROPERTY 会丢失，需要持久化的逐实例状态应放在槽位实例属性中。
+ */
+class SINGULARISINVENTORY_API FInventoryJournal
+{
+public:
+	/**
+	 * 打开名为 Name 的日志并交给共享写入线程，下一条记录使用 NextSequence 作为序号。
+	 * 应先调用 Replay，ItemClasses 为重放得到的物品类表。
+	 */
+	static TSharedRef<FInventoryJournal, ESPMode::ThreadSafe> Open(
+		const FString& Name,
+		uint64 NextSequence,
+		TMap<int32, FString> ItemClasses = {}
+	);
+
+	FInventoryJournal(const FString& Name, uint64 NextSequence, TMap<int32, FString> ItemClasses);
+	~FInventoryJournal();
+
+	/** 记录槽位内容（含实例属性），ItemClass 用于在该 ItemID 首次出现时写入物品类路径 */
+	void RecordSet(int32 SlotIndex, int32 ItemID, int32 Quantity, const FInventoryItemAttributes& Attributes, const UClass* ItemClass);
+	void RecordClear(int32 SlotIndex);
+	void RecordSwap(int32 FromIndex, int32 ToIndex);
+
+	/** 提交快照，快照内容为调用时的全部槽位状态与物品类表，后台线程写出后截断日志 */
+	void WriteSnapshot(TConstArrayView<FInventoryJournalSlotState> SlotStates);
+
+	/** 在调用线程立即写出积累的记录与快照 */
+	void Flush();
+
+	/**
+	 * 关闭日志：把引用交给共享写入线程，写入线程写出剩余记录后释放，调用线程不等待磁盘写入。
+	 * 调用后 Journal 为空。之后的 Replay 会先写出所有正在关闭的日志，重新打开同名日志不会读到不完整的文件。
+	 */
+	static void Close(TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe>&& Journal);
+
+	/** 最后一条已分配的记录序号 */
+	uint64 GetLastSequence() const { return NextSequence - 1; }
+
+	/**
+	 * 读取快照与日志并重放到 InOutSlots，返回最后一条被应用的记录序号，没有任何数据时返回 0。
+	 * InOutSlots 的大小决定可以恢复的槽位范围，超出范围的记录被忽略。
+	 * OutItemClasses 返回快照与日志中记录的 ItemID -> 物品类路径。
+	 * 日志尾部存在不完整或损坏的记录时会把日志文件截断到最后一条有效记录。
+	 */
+	static uint64 Replay(
+		const FString& Name,
+		TArray<FInventoryJournalSlotState>& InOutSlots,
+		TMap<int32, FString>& OutItemClasses
+	);
+
+	/** 停止共享写入线程并写出所有日志的剩余记录，模块卸载时调用 */
+	static void ShutdownWriter();
+
+	/** 日志与快照文件的路径 */
+	static FString GetJournalPath(const FString& Name);
+	static FString GetSnapshotPath(const FString& Name);
+
+private:
+	friend class FInventoryJournalWriter;
+
+	/** 编码一条记录并追加到待写缓冲区 */
+	void Enqueue(
+		EInventoryJournalOp Op,
+		int32 SlotIndex,
+		int32 OtherSlotIndex,
+		int32 ItemID,
+		int32 Quantity,
+		const FInventoryItemAttributes* Attributes = nullptr,
+		FString* ClassPath = nullptr
+	);
+
+	/** 写出当前积累的记录与快照，可以在任意线程调用 */
+	void FlushPending();
+
+	FString JournalPath;
+	FString SnapshotPath;
+
+	/** 以下成员只在游戏线程访问 */
+	uint64 NextSequence;
+	TMap<int32, FString> ItemClasses;
+	TArray<uint8> RecordBuffer;
+
+	/** 游戏线程写入的缓冲区，写入方整体交换取走 */
+	FCriticalSection PendingLock;
+	TArray<uint8> PendingBytes;
+	TArray<uint8> PendingSnapshot;
+
+	/** 快照提交时 PendingBytes 的长度，之前的记录属于旧日志，之后的记录属于新日志 */
+	int32 PendingSnapshotOffset = 0;
+
+	/** 写入方独占，共享写入线程与同步 Flush 通过 WriteLock 互斥 */
+	FCriticalSection WriteLock;
+	TUniquePtr<FArchive> Writer;
+	TArray<uint8> WritingBytes;
+};
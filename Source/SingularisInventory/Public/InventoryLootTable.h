@@ -0,0 +1,166 @@
+/* =====================================================================
+ * InventoryLootTable.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "InventoryLootTable.generated.h"
+
+class UInventoryManager;
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryLootEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落条目",
+		meta = (
+			DisplayName = "物品ID",
+			ToolTip = "掉落物品的ID，必须已在物品注册表中注册"
+		)
+	)
+	int32 ItemID = INDEX_NONE;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落条目",
+		meta = (
+			DisplayName = "权重",
+			ClampMin = "0"
+		)
+	)
+	float Weight = 1.0f;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落条目",
+		meta = (
+			DisplayName = "最小数量",
+			ClampMin = "1"
+		)
+	)
+	int32 MinQuantity = 1;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落条目",
+		meta = (
+			DisplayName = "最大数量",
+			ClampMin = "1"
+		)
+	)
+	int32 MaxQuantity = 1;
+};
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryLootDrop
+{
+	GENERATED_BODY()
+
+	/** 掉落物品的ID，抽中空掉落时为 -1 */
+	UPROPERTY(BlueprintReadOnly, Category = "掉落结果", meta = (DisplayName = "物品ID"))
+	int32 ItemID = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "掉落结果", meta = (DisplayName = "数量"))
+	int32 Quantity = 0;
+};
+
+/**
+ * 掉落表
+ *
+ * 加载或编辑后把条目权重编译为别名表（Vose 算法），单次抽取为 O(1)。
+ * 批量抽取按固定大小分块并行执行，每块使用由种子与块序号派生的随机流，
+ * 因此相同种子的结果与工作线程数量无关。
+ */
+UCLASS(BlueprintType)
+class SINGULARISINVENTORY_API UInventoryLootTable : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落表",
+		meta = (
+			DisplayName = "掉落条目"
+		)
+	)
+	TArray<FInventoryLootEntry> Entries;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "掉落表",
+		meta = (
+			DisplayName = "空掉落权重",
+			ToolTip = "什么都不掉落的权重，与条目权重一起参与抽取",
+			ClampMin = "0"
+		)
+	)
+	float EmptyWeight = 0.0f;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** 按当前条目重建别名表，运行时修改条目后需要手动调用 */
+	void Compile();
+
+	/** 单次抽取，必须已编译 */
+	FInventoryLootDrop Sample(const FRandomStream& Random) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="掉落表",
+		meta = (
+			DisplayName = "批量抽取",
+			ToolTip = "执行指定次数的抽取并返回每次的结果，空掉落的物品ID为 -1。相同种子得到相同结果"
+		)
+	)
+	void SampleDrops(int32 NumDraws, int32 Seed, TArray<FInventoryLootDrop>& OutDrops);
+
+	/** 执行指定次数的抽取并按条目合并数量，输出 (ItemID, 数量) 列表，不包含空掉落 */
+	void SampleTotals(int32 NumDraws, int32 Seed, TArray<TPair<int32, int32>>& OutItemCounts);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="掉落表",
+		meta = (
+			DisplayName = "抽取到库存",
+			ToolTip = "执行指定次数的抽取并把结果批量放入库存，返回实际放入的物品数量"
+		)
+	)
+	int32 GrantTo(UInventoryManager* Inventory, int32 NumDraws, int32 Seed);
+
+private:
+	/** 每个并行块的抽取次数，结果只取决于种子与该值 */
+	static constexpr int32 DrawsPerChunk = 4096;
+
+	void EnsureCompiled();
+
+	/** 抽取条目序号，返回条目数时表示空掉落 */
+	int32 SampleEntry(const FRandomStream& Random) const;
+
+	static int32 SampleQuantity(const FInventoryLootEntry& Entry, const FRandomStream& Random);
+
+	/** 抽中某一列后保留该列的概率，否则取别名列；列序号等于条目数时表示空掉落 */
+	TArray<float> AliasProbability;
+	TArray<int32> AliasIndex;
+
+	bool bCompiled = false;
+};
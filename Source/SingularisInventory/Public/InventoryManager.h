@@ -13,11 +13,21 @@
 #include <InputMappingContext.h>
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "Components/ActorComponent.h"
+#include "InventoryCooldownWheel.h"
+#include "InventoryItemAttributes.h"
+#include "InventoryMemory.h"
 #include "InventoryManager.generated.h"
 
 class UInventoryWidget;
 class UBaseItem;
+class UInventoryManager;
+class FInventorySearchIndex;
+class FInventoryJournal;
+class FInventorySnapshot;
+class FInventorySnapshotPublisher;
+struct FInventoryJournalSlotState;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
 	FOnSlotUpdatedDelegate,
@@ -25,6 +35,52 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
 	SlotIndex
 );
 
+/** 原生槽位变化委托，供 C++ 系统增量维护派生状态，参数为 (库存管理器, 槽位索引) */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInventorySlotChanged, UInventoryManager*, int32);
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(
+	FOnInventorySearchCompleted,
+	const TArray<int32>&,
+	SlotIndices
+);
+
+UENUM(BlueprintType)
+enum class EInventoryItemStorage : uint8
+{
+	Instanced UMETA(DisplayName = "实例存储", ToolTip = "槽位直接强引用物品实例，保留每个实例的全部状态；GC 仍需遍历每个实例，开销不变"),
+	Compact UMETA(DisplayName = "紧凑存储", ToolTip = "槽位只记录 ItemID，物品定义由注册表共享且只读，不为每个物品创建对象")
+};
+
+UENUM(BlueprintType)
+enum class EInventoryBudgetPolicy : uint8
+{
+	LogOnly UMETA(DisplayName = "仅记录日志"),
+	Reject UMETA(DisplayName = "拒绝添加")
+};
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryMemoryUsage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "库存内存", meta = (DisplayName = "管理器字节数"))
+	int64 ManagerBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "库存内存", meta = (DisplayName = "物品字节数"))
+	int64 ItemBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "库存内存", meta = (DisplayName = "图标字节数"))
+	int64 IconBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "库存内存", meta = (DisplayName = "控件字节数"))
+	int64 WidgetBytes = 0;
+
+	int64 GetTotalBytes() const
+	{
+		return ManagerBytes + ItemBytes + IconBytes + WidgetBytes;
+	}
+};
+
 USTRUCT(BlueprintType)
 struct SINGULARISINVENTORY_API FInventorySlot
 {
@@ -36,25 +92,72 @@ struct SINGULARISINVENTORY_API FInventorySlot
 		Category = "库存插槽",
 		meta = (
 			DisplayName = "库存实例",
-			ToolTip = "该库存物品的实例"
+			ToolTip = "该库存物品的实例。实例存储时槽位强引用该对象，GC 需要遍历；紧凑存储的槽位为空，只记录物品ID"
 		)
 	)
 	UBaseItem* Item = nullptr;
 
+	UPROPERTY(
+		BlueprintReadOnly,
+		Category = "库存插槽",
+		meta = (
+			DisplayName = "物品ID",
+			ToolTip = "该槽位物品的ID，紧凑存储的槽位只记录该值"
+		)
+	)
+	int32 ItemID = INDEX_NONE;
+
+	UPROPERTY(
+		BlueprintReadOnly,
+		Category = "库存插槽",
+		meta = (
+			DisplayName = "物品数量",
+			ToolTip = "该槽位堆叠的物品数量"
+		)
+	)
+	int32 Quantity = 0;
+
+	UPROPERTY(
+		BlueprintReadOnly,
+		Category = "库存插槽",
+		meta = (
+			DisplayName = "实例属性",
+			ToolTip = "该槽位物品的实例属性，属性相同的物品才会堆叠"
+		)
+	)
+	FInventoryItemAttributes Attributes;
+
 	UPROPERTY(BlueprintReadOnly, meta=(EditHide))
 	bool bIsEmpty = true;
 
 	void Clear()
 	{
 		Item = nullptr;
+		ItemID = INDEX_NONE;
+		Quantity = 0;
+		Attributes.Reset();
 		bIsEmpty = true;
 	}
 
-	void SetItem(UBaseItem* NewItem)
+	void SetItem(UBaseItem* NewItem, int32 NewQuantity = 1);
+
+	/** 紧凑存储：只记录 ItemID，不引用物品实例 */
+	void SetItemID(int32 NewItemID, int32 NewQuantity = 1)
 	{
-		Item = NewItem;
+		Item = nullptr;
+		ItemID = NewItemID;
+		Quantity = NewQuantity;
+		Attributes.Reset();
 		bIsEmpty = false;
 	}
+
+	/**
+	 * 获取槽位物品
+	 *
+	 * 紧凑存储的槽位返回注册表中共享的只读定义，同 ItemID 的所有紧凑槽位拿到的是同一个对象，
+	 * 其 OnItemUse 也是共享的；需要按槽位区分时应监听库存管理器的槽位事件。
+	 */
+	UBaseItem* GetItem() const;
 };
 
 /**
@@ -97,6 +200,81 @@ public:
 	)
 	int32 SlotSelect;
 
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category="库存管理器|属性",
+		meta = (
+			DisplayName = "物品存储方式",
+			ToolTip = "紧凑存储时添加的物品只记录 ItemID，库存不再引用物品实例，适合大量无独立状态的物品"
+		)
+	)
+	EInventoryItemStorage ItemStorage = EInventoryItemStorage::Instanced;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category="库存管理器|属性",
+		meta = (
+			DisplayName = "创建库存控件",
+			ToolTip = "拥有本地玩家控制器时是否创建库存控件。专用服务器、NPC 与箱子等拥有者始终不会创建控件"
+		)
+	)
+	bool bCreateWidget = true;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category="库存管理器|属性",
+		meta = (
+			DisplayName = "绑定快捷键输入",
+			ToolTip = "拥有本地玩家控制器时是否绑定库存快捷键。专用服务器、NPC 与箱子等拥有者始终不会绑定输入"
+		)
+	)
+	bool bBindInput = true;
+
+#pragma endregion
+
+#pragma region 库存管理器内存预算
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category="库存管理器|内存预算",
+		meta = (
+			DisplayName = "物品内存预算",
+			ToolTip = "库存中物品实例与槽位实例属性允许占用的估算字节数，所有添加物品与设置属性的操作都会检查，0 表示不限制",
+			ClampMin = "0"
+		)
+	)
+	int64 MemoryBudgetBytes = 0;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category="库存管理器|内存预算",
+		meta = (
+			DisplayName = "超出预算时的策略",
+			ToolTip = "添加物品超出内存预算时，仅记录日志或者拒绝添加"
+		)
+	)
+	EInventoryBudgetPolicy BudgetPolicy = EInventoryBudgetPolicy::LogOnly;
+
+#pragma endregion
+
+#pragma region 库存管理器持久化
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadWrite,
+		Category="库存管理器|持久化",
+		meta = (
+			DisplayName = "操作日志名称",
+			ToolTip = "非空时在 BeginPlay 从同名快照与操作日志恢复槽位，之后的槽位变化由后台线程追加到操作日志。名称需在同一进程内唯一。日志记录 ItemID、数量与槽位实例属性，只有紧凑存储可以无损恢复；实例存储的物品恢复为共享的物品定义，物品实例自身被修改过的属性不会保留"
+		)
+	)
+	FString JournalName;
+
 #pragma endregion
 
 #pragma region 库存管理器输入
@@ -261,6 +439,12 @@ public:
 	)
 	FOnSlotUpdatedDelegate OnSlotUpdated;
 
+	/** 槽位内容变化时广播，选中槽位变化不会触发 */
+	FOnInventorySlotChanged OnSlotChangedNative;
+
+	/** 选中槽位变化时广播，参数为新的选中索引 */
+	FOnInventorySlotChanged OnSlotSelectChangedNative;
+
 #pragma endregion
 
 #pragma region 常规
@@ -268,15 +452,47 @@ public:
 private:
 	TWeakObjectPtr<APlayerController> PlayerController = nullptr;
 
+	/** 当前已添加输入映射并绑定输入动作的玩家控制器 */
+	TWeakObjectPtr<APlayerController> InputBoundController = nullptr;
+
+	/** 名称搜索索引，工作线程查询时通过共享指针保持存活 */
+	TSharedPtr<FInventorySearchIndex, ESPMode::ThreadSafe> SearchIndex;
+
+	/** 预写操作日志，未配置日志名称时为空 */
+	TSharedPtr<FInventoryJournal, ESPMode::ThreadSafe> Journal;
+
+	/** 供其他线程读取的不可变快照，每帧最多发布一次 */
+	TSharedPtr<FInventorySnapshotPublisher, ESPMode::ThreadSafe> SnapshotPublisher;
+
+	/** 当前计入预算的估算字节数（物品实例与槽位实例属性），随增删增量维护 */
+	int64 TrackedItemBytes = 0;
+
+	/** 等待本帧批量执行的使用请求 */
+	struct FUseRequest
+	{
+		int32 SlotIndex;
+		int32 ItemID;
+	};
+	SingularisInventory::TScratchArray<FUseRequest> PendingUses;
+
+	/** 本批次内发生变化、尚未通知界面与委托的槽位 */
+	SingularisInventory::TScratchBitArray<> DirtySlotMask;
+	SingularisInventory::TScratchArray<int32> DirtySlots;
+
+	/** 按 ItemID 共享的使用冷却 */
+	FInventoryCooldownWheel UseCooldowns;
+
 public:
 	UInventoryManager();
 
 protected:
 	virtual void BeginPlay() override;
 	virtual void OnRegister() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 
 #pragma endregion
 
@@ -284,14 +500,89 @@ private:
 #pragma region 库存管理器函数
 
 	void CreateInteractionWidget();
+
+	/** 需要逐槽位接收蓝图事件的控件，控件使用原生槽位网格时返回 nullptr */
+	UInventoryWidget* GetSlotEventWidget() const;
+
+	/** 从拥有者解析玩家控制器：拥有者本身或拥有者 Pawn 的控制器 */
+	APlayerController* ResolvePlayerController() const;
+
+	/** 是否需要创建界面与绑定输入：仅限非服务器且拥有本地玩家控制器 */
+	bool ShouldCreatePresentation() const;
+
+	/** 按当前控制器创建或移除界面与输入绑定，开始游戏与控制器变化时调用 */
+	void UpdatePresentation();
+
+	/** 拥有者 Pawn 被重新控制或失去控制时刷新界面与输入 */
+	UFUNCTION()
+	void HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
 	void InputFinder();
 	static void LoadInputAction(UInputAction*& InputAction, const TCHAR* Path);
 
+	/** 槽位内容变化后的统一通知入口，bJournal 为 false 时不写入操作日志 */
+	void NotifySlotChanged(int32 SlotIndex, bool bJournal = true);
+
+	/** 从快照与操作日志恢复槽位，并打开操作日志 */
+	void RestoreFromJournal();
+
+	/** 查找恢复槽位所需的物品定义，注册表中没有时按日志记录的类路径加载并注册 */
+	static const UBaseItem* ResolveJournalDefinition(int32 ItemID, const TMap<int32, FString>& ItemClasses);
+
+	/** 收集全部槽位的 (ItemID, 数量, 实例属性)，供快照与重放使用 */
+	void GetJournalSlotStates(TArray<FInventoryJournalSlotState>& OutStates) const;
+
+	/** 标记槽位内容已变化，在 FlushDirtySlots 时统一刷新界面并广播 */
+	void MarkSlotDirty(int32 SlotIndex);
+
+	/** 合并刷新本批次所有变化的槽位，每个槽位只刷新一次 */
+	void FlushDirtySlots();
+
+	/** 批量添加同 ID 物品并标记变化的槽位，不刷新 */
+	int32 AddItemsByIDDeferred(int32 ItemID, int32 Count);
+
+	/** 减少槽位物品数量但不刷新，只把槽位标记为脏，数量不足时失败 */
+	bool RemoveItemCountDeferred(int32 SlotIndex, int32 Count);
+
+	/** 按槽位当前内容刷新界面 */
+	void RefreshSlotWidget(int32 SlotIndex) const;
+
+	/** 批量执行本帧排队的使用请求 */
+	void ProcessUseRequests();
+
+	/** 是否应以紧凑方式存储该物品，必要时会把物品类注册到物品注册表 */
+	bool ShouldStoreCompact(const UBaseItem* Item) const;
+
+	/** 查找可以继续堆叠的紧凑槽位 */
+	int32 FindStackSlot(
+		int32 ItemID,
+		int32 MaxStackSize,
+		const FInventoryItemAttributes& Attributes = FInventoryItemAttributes::Empty
+	) const;
+
+	/** 将物品写入空槽位 */
+	void StoreItem(
+		int32 SlotIndex,
+		UBaseItem* Item,
+		bool bCompact,
+		const FInventoryItemAttributes& Attributes = FInventoryItemAttributes::Empty
+	);
+
+	/** 检查新增 AddedBytes 估算字节后是否超出内存预算，返回 false 表示应拒绝本次添加 */
+	bool CheckMemoryBudget(const UBaseItem* Item, int64 AddedBytes) const;
+
+	/** 估算单个物品实例的字节数 */
+	static int64 EstimateItemBytes(const UBaseItem* Item);
+
+	/** 估算槽位计入预算的字节数：实例存储的物品实例加上溢出到堆上的实例属性 */
+	static int64 EstimateSlotBytes(const FInventorySlot& Slot);
+
 #pragma endregion
 
 #pragma region 输入绑定函数
 
 	void BindInputs();
+	void UnbindInputs();
 	void HandleOne(const FInputActionValue& Value);
 	void HandleTwo(const FInputActionValue& Value);
 	void HandleThree(const FInputActionValue& Value);
@@ -318,6 +609,19 @@ public:
 	)
 	bool TryAddItem(UBaseItem* Item);
 
+	/** 添加物品实例并附带实例属性，紧凑存储时只与属性相同的槽位堆叠，例如卸下的装备放回库存 */
+	bool TryAddItemInstance(UBaseItem* Item, const FInventoryItemAttributes& Attributes);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|操作函数",
+		meta = (
+			DisplayName = "通过ID添加物品",
+			ToolTip = "以紧凑存储方式添加已在物品注册表中注册的物品，不需要创建物品实例"
+		)
+	)
+	bool TryAddItemByID(int32 ItemID);
+
 	UFUNCTION(
 		BlueprintCallable,
 		Category="库存管理器|操作函数",
@@ -328,6 +632,95 @@ public:
 	)
 	bool RemoveItemByIndex(int32 SlotIndex);
 
+	/**
+	 * 获取最近发布的库存快照（ItemID、数量与价值）
+	 *
+	 * 快照在每帧的槽位变化之后发布，取得后不会再变化，可以交给任意线程读取。
+	 */
+	TSharedPtr<const FInventorySnapshot, ESPMode::ThreadSafe> GetSnapshot() const;
+
+	/** 获取快照发布器，工作线程可以持有它并随时取得最新快照，而无需访问库存管理器本身 */
+	TSharedPtr<FInventorySnapshotPublisher, ESPMode::ThreadSafe> GetSnapshotPublisher() const { return SnapshotPublisher; }
+
+	/** 立即发布包含当前所有变化的快照，通常不需要调用，TickComponent 会在每帧结束前发布 */
+	void PublishSnapshot();
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|持久化",
+		meta = (
+			DisplayName = "写入库存快照",
+			ToolTip = "把当前全部槽位写入快照并截断操作日志，写入在后台线程完成"
+		)
+	)
+	void SaveJournalSnapshot();
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|操作函数",
+		meta = (
+			DisplayName = "添加带实例属性的物品",
+			ToolTip = "以紧凑方式添加一个带实例属性的物品，只与 ID 和属性都相同的槽位堆叠"
+		)
+	)
+	bool TryAddItemWithAttributes(int32 ItemID, const FInventoryItemAttributes& Attributes);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="库存管理器|实例属性",
+		meta = (
+			DisplayName = "获取槽位实例属性",
+			ToolTip = "获取槽位物品的实例属性，不存在时返回默认值"
+		)
+	)
+	int32 GetSlotAttribute(int32 SlotIndex, FName Key, int32 DefaultValue = 0) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|实例属性",
+		meta = (
+			DisplayName = "设置槽位实例属性",
+			ToolTip = "设置槽位物品的实例属性，对整个堆叠生效"
+		)
+	)
+	bool SetSlotAttribute(int32 SlotIndex, FName Key, int32 Value);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|实例属性",
+		meta = (
+			DisplayName = "移除槽位实例属性"
+		)
+	)
+	bool RemoveSlotAttribute(int32 SlotIndex, FName Key);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|操作函数",
+		meta = (
+			DisplayName = "通过物品ID批量添加物品",
+			ToolTip = "以紧凑方式批量添加多个同 ID 物品，先填满已有堆叠再占用空槽位，每个变化的槽位只刷新一次。返回实际添加的数量"
+		)
+	)
+	int32 TryAddItemsByID(int32 ItemID, int32 Count);
+
+	/** 批量添加多种物品，参数为 (ItemID, 数量) 列表，所有变化的槽位在最后统一刷新。返回实际添加的总数量 */
+	int32 TryAddItemBatch(TConstArrayView<TPair<int32, int32>> ItemCounts);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|操作函数",
+		meta = (
+			DisplayName = "通过索引减少物品数量",
+			ToolTip = "从指定槽位移除给定数量的物品，数量不足时失败，减到 0 时清空槽位"
+		)
+	)
+	bool RemoveItemCount(int32 SlotIndex, int32 Count);
+
+	/** 批量减少多个槽位的物品数量，参数为 (槽位索引, 数量) 列表，所有变化的槽位在最后统一刷新。返回实际移除的总数量 */
+	int32 RemoveItemCountBatch(TConstArrayView<TPair<int32, int32>> SlotCounts);
+
 	UFUNCTION(
 		BlueprintCallable,
 		Category="库存管理器|操作函数",
@@ -338,6 +731,9 @@ public:
 	)
 	void SwapSlots(int32 FromIndex, int32 ToIndex);
 
+	/** 把槽位恢复为之前复制的内容，用于撤销跨组件的多步操作；恢复的是已有状态，不受内存预算约束 */
+	void RestoreSlot(int32 SlotIndex, const FInventorySlot& Slot);
+
 	UFUNCTION(
 		BlueprintCallable,
 		Category="库存管理器|操作函数",
@@ -353,7 +749,7 @@ public:
 		Category="库存管理器|操作函数",
 		meta = (
 			DisplayName = "获取槽位物品",
-			ToolTip = "通过索引获取指定槽位的物品"
+			ToolTip = "通过索引获取指定槽位的物品，紧凑存储的槽位返回共享的只读物品定义，不应修改或绑定其委托"
 		)
 	)
 	UBaseItem* GetItemInSlot(int32 SlotIndex) const;
@@ -378,5 +774,87 @@ public:
 	)
 	void SetSlotSelect(int32 Index);
 
+#pragma endregion
+
+#pragma region 库存管理器使用函数
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|使用函数",
+		meta = (
+			DisplayName = "使用物品",
+			ToolTip = "把槽位物品的使用请求加入队列，在本帧末批量执行：触发 OnItemUse，消耗品数量减一或移除，并统一刷新一次槽位。返回请求是否被接受"
+		)
+	)
+	bool UseItem(int32 SlotIndex);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|使用函数",
+		meta = (
+			DisplayName = "批量使用物品",
+			ToolTip = "一次加入多个槽位的使用请求，返回被接受的请求数量"
+		)
+	)
+	int32 UseItems(const TArray<int32>& SlotIndices);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="库存管理器|使用函数",
+		meta = (
+			DisplayName = "获取物品剩余冷却",
+			ToolTip = "获取指定 ItemID 的剩余使用冷却秒数"
+		)
+	)
+	float GetItemCooldownRemaining(int32 ItemID) const;
+
+#pragma endregion
+
+#pragma region 库存管理器搜索函数
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|搜索函数",
+		meta = (
+			DisplayName = "异步搜索物品",
+			ToolTip = "在工作线程中按物品显示名称搜索库存，完成后在游戏线程回调匹配的槽位索引。连续搜索时只回调最后一次的结果。"
+		)
+	)
+	void SearchItemsAsync(const FString& Query, FOnInventorySearchCompleted OnCompleted);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|搜索函数",
+		meta = (
+			DisplayName = "重建搜索索引",
+			ToolTip = "当直接修改了 Slots 数组时，调用该函数重建名称搜索索引"
+		)
+	)
+	void RebuildSearchIndex();
+
+	/** 在工作线程中按物品显示名称搜索库存，返回匹配槽位索引的 Future */
+	TFuture<TArray<int32>> SearchItems(const FString& Query) const;
+
+#pragma endregion
+
+#pragma region 库存管理器内存函数
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存管理器|内存函数",
+		meta = (
+			DisplayName = "获取内存占用",
+			ToolTip = "估算库存管理器、物品实例、已加载图标与控件的内存占用"
+		)
+	)
+	FInventoryMemoryUsage GetMemoryUsage() const;
+
+	/** 与 GetMemoryUsage 相同，同时按物品类累计物品字节数，已统计过的图标不会重复计入 */
+	FInventoryMemoryUsage CollectMemoryUsage(
+		SingularisInventory::TScratchMap<const UClass*, int64>& OutBytesPerClass,
+		SingularisInventory::TScratchSet<const UObject*>& InOutCountedIcons
+	) const;
+
 #pragma endregion
 };
@@ -0,0 +1,146 @@
+/* =====================================================================
+ * InventoryMemory.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+#include "SingularisInventory.h"
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Scratch Buffer Spills"),
+	STAT_SingularisInventory_ScratchSpills,
+	STATGROUP_SingularisInventory,
+	SINGULARISINVENTORY_API
+);
+
+namespace SingularisInventory
+{
+	/**
+	 * 临时缓冲区（TScratchArray、TScratchBitArray、TScratchSet、TScratchMap）超出内联容量、
+	 * 溢出到堆上的累计次数，稳态下应保持不变。
+	 *
+	 * 该计数只覆盖上述临时容器，不包括长期持有的结构（搜索索引的倒排表、操作日志的待写缓冲区等）、
+	 * 返回给调用方的结果数组（例如搜索结果）以及异步任务自身的分配；这些分配归入 SingularisInventory 的 LLM 标签。
+	 * TArenaArray 分配在线性内存栈上，页面由 FMemStack 复用，同样不计入。
+	 */
+	extern SINGULARISINVENTORY_API std::atomic<uint64> GScratchSpills;
+
+	/** 记录一次临时缓冲区溢出到堆 */
+	FORCEINLINE void RecordScratchSpill()
+	{
+		GScratchSpills.fetch_add(1, std::memory_order_relaxed);
+		INC_DWORD_STAT(STAT_SingularisInventory_ScratchSpills);
+	}
+
+	/** 读取临时缓冲区溢出到堆的累计次数 */
+	FORCEINLINE uint64 GetScratchSpillCount()
+	{
+		return GScratchSpills.load(std::memory_order_relaxed);
+	}
+}
+
+/**
+ * 带计数的堆分配器
+ *
+ * 行为与 FHeapAllocator 相同，只是每次真正向堆申请内存时都会计入溢出次数，
+ * 作为内联分配器的二级分配器使用，用来发现内联容量不足的临时缓冲区。
+ */
+class FInventoryCountingHeapAllocator
+{
+public:
+	using SizeType = FHeapAllocator::SizeType;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType : public FHeapAllocator::ForAnyElementType
+	{
+		using Super = FHeapAllocator::ForAnyElementType;
+
+	public:
+		FORCEINLINE void ResizeAllocation(const SizeType CurrentNum, const SizeType NewMax, const SIZE_T NumBytesPerElement)
+		{
+			if (NewMax > 0) SingularisInventory::RecordScratchSpill();
+			Super::ResizeAllocation(CurrentNum, NewMax, NumBytesPerElement);
+		}
+
+		FORCEINLINE void ResizeAllocation(const SizeType CurrentNum, const SizeType NewMax, const SIZE_T NumBytesPerElement, const uint32 AlignmentOfElement)
+		{
+			if (NewMax > 0) SingularisInventory::RecordScratchSpill();
+			Super::ResizeAllocation(CurrentNum, NewMax, NumBytesPerElement, AlignmentOfElement);
+		}
+	};
+
+	template <typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		FORCEINLINE ElementType* GetAllocation() const
+		{
+			return static_cast<ElementType*>(ForAnyElementType::GetAllocation());
+		}
+	};
+};
+
+template <>
+struct TAllocatorTraits<FInventoryCountingHeapAllocator> : TAllocatorTraits<FHeapAllocator>
+{
+};
+
+namespace SingularisInventory
+{
+	/** 临时缓冲区的默认内联容量，覆盖常见的快捷栏与单次拾取规模 */
+	constexpr int32 ScratchInlineCount = 16;
+
+	/** 优先使用内联存储的临时数组，溢出时会被计入溢出统计 */
+	template <typename ElementType, int32 InlineCount = ScratchInlineCount>
+	using TScratchArray = TArray<ElementType, TInlineAllocator<InlineCount, FInventoryCountingHeapAllocator>>;
+
+	/** 优先使用内联存储的临时位数组，默认内联 128 位，溢出时会被计入溢出统计 */
+	template <int32 InlineWords = 4>
+	using TScratchBitArray = TBitArray<TInlineAllocator<InlineWords, FInventoryCountingHeapAllocator>>;
+
+	/** 溢出时计入溢出统计的集合分配器，用作 TScratchSet 与 TScratchMap 的二级分配器 */
+	using FCountingSetAllocator = TSetAllocator<
+		TSparseArrayAllocator<FInventoryCountingHeapAllocator, FInventoryCountingHeapAllocator>,
+		FInventoryCountingHeapAllocator
+	>;
+
+	/** 优先使用内联存储的临时集合，溢出时会被计入溢出统计 */
+	template <typename ElementType, int32 InlineCount = ScratchInlineCount>
+	using TScratchSet = TSet<ElementType, DefaultKeyFuncs<ElementType>, TInlineSetAllocator<InlineCount, FCountingSetAllocator>>;
+
+	/** 优先使用内联存储的临时映射，溢出时会被计入溢出统计 */
+	template <typename KeyType, typename ValueType, int32 InlineCount = ScratchInlineCount>
+	using TScratchMap = TMap<KeyType, ValueType, TInlineSetAllocator<InlineCount, FCountingSetAllocator>>;
+
+	/** 分配在线性内存栈上的临时数组，必须处于 FInventoryScratchScope 作用域内，用于数量没有上限的批量临时数据 */
+	template <typename ElementType>
+	using TArenaArray = TArray<ElementType, TMemStackAllocator<>>;
+
+	/**
+	 * 临时缓冲区作用域
+	 *
+	 * 在当前线程的 FMemStack 上打标记，离开作用域时整体回收期间的所有分配。
+	 * 内存栈的页面在帧之间复用，预热之后作用域内的分配不再向堆申请内存。
+	 */
+	class FInventoryScratchScope
+	{
+	public:
+		FInventoryScratchScope() : Mark(FMemStack::Get())
+		{
+		}
+
+	private:
+		FMemMark Mark;
+	};
+}
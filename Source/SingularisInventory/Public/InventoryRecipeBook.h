@@ -0,0 +1,114 @@
+/* =====================================================================
+ * InventoryRecipeBook.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "InventoryRecipeBook.generated.h"
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryRecipeIngredient
+{
+	GENERATED_BODY()
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方材料",
+		meta = (
+			DisplayName = "物品ID",
+			ToolTip = "材料物品的ID"
+		)
+	)
+	int32 ItemID = INDEX_NONE;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方材料",
+		meta = (
+			DisplayName = "数量",
+			ClampMin = "1"
+		)
+	)
+	int32 Quantity = 1;
+};
+
+USTRUCT(BlueprintType)
+struct SINGULARISINVENTORY_API FInventoryRecipe
+{
+	GENERATED_BODY()
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方",
+		meta = (
+			DisplayName = "配方名称",
+			ToolTip = "配方的唯一名称，用于界面显示与查找"
+		)
+	)
+	FName RecipeName;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方",
+		meta = (
+			DisplayName = "材料"
+		)
+	)
+	TArray<FInventoryRecipeIngredient> Ingredients;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方",
+		meta = (
+			DisplayName = "产物物品ID",
+			ToolTip = "合成产物的物品ID，必须已在物品注册表中注册"
+		)
+	)
+	int32 ResultItemID = INDEX_NONE;
+
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方",
+		meta = (
+			DisplayName = "产物数量",
+			ClampMin = "1"
+		)
+	)
+	int32 ResultQuantity = 1;
+};
+
+/**
+ * 合成配方集
+ *
+ * 以 ItemID 引用材料与产物，注册到合成子系统后参与配方索引。
+ */
+UCLASS(BlueprintType)
+class SINGULARISINVENTORY_API UInventoryRecipeBook : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(
+		EditAnywhere,
+		BlueprintReadOnly,
+		Category = "配方集",
+		meta = (
+			DisplayName = "配方",
+			TitleProperty = "RecipeName"
+		)
+	)
+	TArray<FInventoryRecipe> Recipes;
+};
@@ -0,0 +1,73 @@
+/* =====================================================================
+ * InventorySearchIndex.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "InventoryMemory.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/StringBuilder.h"
+
+class UBaseItem;
+
+/**
+ * 库存名称搜索索引
+ *
+ * 为每个库存维护一份规范化（小写折叠）后的物品名称表以及三元组倒排表。
+ * 写入只发生在游戏线程且仅更新变化的槽位，查询可以在任意工作线程执行。
+ */
+class SINGULARISINVENTORY_API FInventorySearchIndex
+{
+public:
+	/** 清空索引并按槽位数量重新分配 */
+	void Reset(int32 NumSlots);
+
+	/** 更新单个槽位的索引项（游戏线程） */
+	void UpdateSlot(int32 SlotIndex, const UBaseItem* Item);
+
+	/** 查询名称包含 Text 的槽位索引，结果按槽位升序排列（任意线程） */
+	TArray<int32> Query(const FString& Text) const;
+
+	/** 登记一次新的异步查询，返回其序号 */
+	uint32 BeginQuery() { return ++LatestQuery; }
+
+	/** 判断序号是否仍是最近一次查询，用于丢弃被新输入覆盖的结果 */
+	bool IsLatestQuery(const uint32 Serial) const { return LatestQuery.load() == Serial; }
+
+	/** 估算索引占用的内存字节数 */
+	SIZE_T GetAllocatedSize() const;
+
+	/** 将名称规范化为搜索使用的形式：去除首尾空白并小写折叠 */
+	static FString Normalize(const FString& Name);
+
+	/** 将规范化后的名称追加到字符串构建器，不产生堆分配 */
+	static void NormalizeInto(FStringView Name, FStringBuilderBase& Out);
+
+private:
+	/** 三元组 -> 倒排键 */
+	static uint64 MakeGramKey(TCHAR A, TCHAR B, TCHAR C);
+
+	/** 收集字符串中所有不重复的三元组 */
+	static void CollectGrams(const FString& Name, SingularisInventory::TScratchArray<uint64, 32>& OutGrams);
+
+	void RemoveSlotGrams_Locked(int32 SlotIndex);
+	void AddSlotGrams_Locked(int32 SlotIndex);
+
+	mutable FRWLock Lock;
+
+	std::atomic<uint32> LatestQuery{0};
+
+	/** 槽位索引 -> 规范化名称，空槽位为空字符串 */
+	TArray<FString> Names;
+
+	/** 三元组 -> 包含该三元组的槽位列表 */
+	TMap<uint64, TArray<int32>> Grams;
+};
@@ -0,0 +1,111 @@
+/* =====================================================================
+ * InventorySnapshot.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FInventorySlot;
+
+/** 快照中的单个槽位，只包含值类型，任何线程都可以读取 */
+struct FInventorySnapshotSlot
+{
+	int32 ItemID = INDEX_NONE;
+	int32 Quantity = 0;
+
+	/** 单个物品的价值，发布时从物品定义中读取 */
+	float Value = 0.0f;
+
+	bool IsEmpty() const { return ItemID == INDEX_NONE || Quantity <= 0; }
+};
+
+/**
+ * 不可变的库存快照
+ *
+ * 槽位按固定大小分块，每块由共享指针持有。发布新快照时只重建发生变化的块，
+ * 未变化的块在新旧快照之间共享（写时复制），因此发布开销与变化的槽位数量成正比。
+ */
+class SINGULARISINVENTORY_API FInventorySnapshot
+{
+public:
+	static constexpr int32 SlotsPerChunk = 64;
+
+	int32 Num() const { return NumSlots; }
+
+	const FInventorySnapshotSlot& GetSlot(const int32 SlotIndex) const
+	{
+		check(SlotIndex >= 0 && SlotIndex < NumSlots);
+		return Chunks[SlotIndex / SlotsPerChunk]->Slots[SlotIndex % SlotsPerChunk];
+	}
+
+	/** 发布序号，每次发布递增 */
+	uint64 GetVersion() const { return Version; }
+
+	/** 全部物品价值 × 数量的合计 */
+	double GetTotalValue() const;
+
+	/** 遍历非空槽位，回调参数为 (槽位索引, 槽位) */
+	template <typename FunctorType>
+	void ForEachOccupiedSlot(FunctorType&& Functor) const
+	{
+		for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+		{
+			const FInventorySnapshotSlot& Slot = GetSlot(SlotIndex);
+			if (!Slot.IsEmpty())
+				Functor(SlotIndex, Slot);
+		}
+	}
+
+private:
+	friend class FInventorySnapshotPublisher;
+
+	struct FChunk
+	{
+		FInventorySnapshotSlot Slots[SlotsPerChunk];
+		double TotalValue = 0.0;
+	};
+
+	TArray<TSharedRef<const FChunk, ESPMode::ThreadSafe>> Chunks;
+	int32 NumSlots = 0;
+	uint64 Version = 0;
+};
+
+/**
+ * 库存快照发布器
+ *
+ * 游戏线程标记变化的槽位并在一批修改结束后发布新快照；其他线程通过 GetLatest 取得当前快照，
+ * 取得后该快照不会再被修改，可以在工作线程上随意读取，直到释放引用。
+ */
+class SINGULARISINVENTORY_API FInventorySnapshotPublisher
+{
+public:
+	FInventorySnapshotPublisher();
+
+	/** 标记槽位已变化，只能在游戏线程调用 */
+	void MarkDirty(int32 SlotIndex);
+
+	bool HasPendingChanges() const { return bHasPendingChanges; }
+
+	/** 按槽位当前内容发布新快照，只能在游戏线程调用 */
+	void Publish(TConstArrayView<FInventorySlot> Slots);
+
+	/** 获取最近发布的快照，任何线程都可以调用 */
+	TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> GetLatest() const;
+
+private:
+	TBitArray<> DirtyChunks;
+	bool bHasPendingChanges = true;
+
+	/**
+	 * 读锁只保护共享指针的复制本身，不覆盖对快照内容的读取；
+	 * 游戏线程每次发布只持有写锁完成一次指针替换
+	 */
+	mutable FRWLock LatestLock;
+	TSharedRef<const FInventorySnapshot, ESPMode::ThreadSafe> Latest;
+};
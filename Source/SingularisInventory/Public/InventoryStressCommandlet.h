@@ -0,0 +1,35 @@
+/* =====================================================================
+ * InventoryStressCommandlet.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "InventoryStressCommandlet.generated.h"
+
+/**
+ * 库存吞吐压力测试命令行工具
+ *
+ * 用法：UnrealEditor-Cmd <Project>.uproject -run=InventoryStress -nullrhi -unattended
+ *       [-Inventories=200] [-Slots=1000] [-Ops=1000000] [-GCInterval=100000] [-Seed=0]
+ *       [-Compact] [-Prefill] [-MeasureGC=5]
+ *
+ * 世界物品空间查询基准：-run=InventoryStress -Mode=Spatial
+ *       [-Items=10000] [-Players=64] [-Frames=600] [-Churn=32] [-Radius=300] [-CellSize=500]
+ */
+UCLASS()
+class SINGULARISINVENTORY_API UInventoryStressCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UInventoryStressCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,161 @@
+/* =====================================================================
+ * InventoryStressTest.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BaseItem.h"
+#include "InventoryStressTest.generated.h"
+
+/**
+ * 压力测试使用的具体物品类
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class SINGULARISINVENTORY_API UInventoryStressItem : public UBaseItem
+{
+	GENERATED_BODY()
+};
+
+/** 压力测试参数 */
+struct SINGULARISINVENTORY_API FInventoryStressParams
+{
+	/** 模拟的库存管理器数量 */
+	int32 NumInventories = 200;
+
+	/** 每个库存的槽位数量 */
+	int32 SlotsPerInventory = 1000;
+
+	/** 总操作次数 */
+	int32 NumOperations = 1000000;
+
+	/** 每执行多少次操作触发一次完整 GC，0 表示不触发 */
+	int32 GCInterval = 100000;
+
+	/** 随机种子，相同的种子产生相同的操作序列 */
+	int32 Seed = 0;
+
+	/** 使用紧凑存储（只记录 ItemID），对比实例存储的 GC 开销 */
+	bool bCompactStorage = false;
+
+	/** 开始操作前先填满所有槽位 */
+	bool bPrefill = false;
+
+	/** 操作结束后额外执行并单独计时的完整 GC 次数，用于测量稳态标记耗时 */
+	int32 MeasuredGCRuns = 0;
+
+	/** 以相同参数依次运行实例存储与紧凑存储并对比结果，忽略 bCompactStorage */
+	bool bCompareStorage = false;
+
+	/**
+	 * 从命令行风格的参数中解析，例如
+	 * "-Inventories=200 -Slots=1000 -Ops=1000000 -GCInterval=100000 -Seed=0 [-Compact] [-Prefill] [-MeasureGC=5] [-CompareStorage]"
+	 *
+	 * 测量 10 万个物品的稳态 GC 标记耗时：
+	 * "-Inventories=100 -Slots=1000 -Ops=0 -GCInterval=0 -Prefill -MeasureGC=10 -CompareStorage"
+	 */
+	void Parse(const TCHAR* Params);
+};
+
+/** 压力测试结果 */
+struct SINGULARISINVENTORY_API FInventoryStressResult
+{
+	int64 NumOperations = 0;
+	double TotalSeconds = 0.0;
+	double OpsPerSecond = 0.0;
+	double P50Microseconds = 0.0;
+	double P99Microseconds = 0.0;
+	double MaxMicroseconds = 0.0;
+	int32 NumGCRuns = 0;
+	double GCMilliseconds = 0.0;
+
+	/** 结束时库存中存放的物品总数 */
+	int64 NumStoredItems = 0;
+
+	/** 额外完整 GC 的平均耗时 */
+	int32 NumMeasuredGCRuns = 0;
+	double MeasuredGCAverageMilliseconds = 0.0;
+
+	FString ToString() const;
+};
+
+/** 世界物品空间查询基准参数 */
+struct SINGULARISINVENTORY_API FItemSpatialBenchmarkParams
+{
+	/** 世界中的物品数量 */
+	int32 NumItems = 10000;
+
+	/** 每帧执行拾取查询的玩家数量 */
+	int32 NumPlayers = 64;
+
+	/** 模拟的帧数 */
+	int32 NumFrames = 600;
+
+	/** 每帧被拾取并在别处重新掉落的物品数量 */
+	int32 ChurnPerFrame = 32;
+
+	/** 物品分布的正方形区域边长（厘米） */
+	float WorldSize = 40000.0f;
+
+	/** 拾取半径（厘米） */
+	float PickupRadius = 300.0f;
+
+	/** 网格单元边长（厘米） */
+	float CellSize = 500.0f;
+
+	int32 Seed = 0;
+
+	/** 例如 "-Items=10000 -Players=64 -Frames=600 -Churn=32 -WorldSize=40000 -Radius=300 -CellSize=500 -Seed=0" */
+	void Parse(const TCHAR* Params);
+};
+
+/** 世界物品空间查询基准结果 */
+struct SINGULARISINVENTORY_API FItemSpatialBenchmarkResult
+{
+	/** 空间哈希每帧（全部玩家的半径查询与最近查询）平均耗时 */
+	double HashMicrosecondsPerFrame = 0.0;
+
+	/** 逐个遍历全部物品的对照实现每帧平均耗时 */
+	double BruteForceMicrosecondsPerFrame = 0.0;
+
+	/** 每次半径查询平均命中的物品数量，两种实现必须一致 */
+	double AverageHitsPerQuery = 0.0;
+	bool bResultsMatch = true;
+
+	FString ToString() const;
+};
+
+namespace SingularisInventory
+{
+	/**
+	 * 运行库存吞吐压力测试
+	 *
+	 * 创建若干个未注册的 UInventoryManager，按随机比例执行添加、删除、交换与选中操作，
+	 * 统计每次操作的耗时分布以及期间 GC 的耗时。必须在游戏线程调用。
+	 */
+	SINGULARISINVENTORY_API FInventoryStressResult RunStressTest(const FInventoryStressParams& Params);
+
+	/**
+	 * 以相同参数依次运行实例存储与紧凑存储的压力测试，返回 (实例存储结果, 紧凑存储结果)
+	 *
+	 * 实例存储的每个槽位都强引用一个物品实例，紧凑存储的槽位只记录 ItemID，
+	 * 两者的稳态 GC 耗时之差即为槽位引用给可达性分析带来的开销。
+	 */
+	SINGULARISINVENTORY_API TPair<FInventoryStressResult, FInventoryStressResult> RunStorageComparison(FInventoryStressParams Params);
+
+	/** 输出存储方式对比结果 */
+	SINGULARISINVENTORY_API FString DescribeStorageComparison(const TPair<FInventoryStressResult, FInventoryStressResult>& Results);
+
+	/**
+	 * 运行世界物品空间查询基准
+	 *
+	 * 直接驱动 FItemSpatialHash，不需要世界。每帧先随机移除并重新添加部分物品，
+	 * 然后每个玩家执行一次半径查询与一次最近查询，并与逐个遍历的结果对照。
+	 */
+	SINGULARISINVENTORY_API FItemSpatialBenchmarkResult RunSpatialBenchmark(const FItemSpatialBenchmarkParams& Params);
+}
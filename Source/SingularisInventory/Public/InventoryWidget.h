@@ -14,6 +14,7 @@
 #include "InventoryWidget.generated.h"
 
 class UBaseItem;
+class UInventoryManager;
 
 /**
  * 库存控件基类
@@ -24,8 +25,33 @@ class SINGULARISINVENTORY_API UInventoryWidget : public UUserWidget
 	GENERATED_BODY()
 
 public:
+#pragma region 库存控件属性
+
+	UPROPERTY(
+		EditDefaultsOnly,
+		BlueprintReadOnly,
+		Category="库存控件|属性",
+		meta = (
+			DisplayName = "使用原生槽位网格",
+			ToolTip = "控件中使用库存槽位网格绘制槽位时勾选，库存管理器将不再逐槽位调用下方的蓝图接口"
+		)
+	)
+	bool bUseNativeSlotGrid = false;
+
+#pragma endregion
+
 #pragma region 库存控件函数
 
+	UFUNCTION(
+		BlueprintCallable,
+		Category="库存控件|函数",
+		meta = (
+			DisplayName = "绑定库存",
+			ToolTip = "把控件中所有库存槽位网格绑定到指定的库存管理器，库存管理器创建控件时会自动调用"
+		)
+	)
+	void BindInventory(UInventoryManager* Inventory);
+
 	UFUNCTION(
 		BlueprintCallable,
 		Category="库存控件|函数",
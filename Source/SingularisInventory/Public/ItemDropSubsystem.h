@@ -0,0 +1,155 @@
+/* =====================================================================
+ * ItemDropSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ItemSpatialHash.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemDropSubsystem.generated.h"
+
+class ABaseItemActor;
+class UBaseItem;
+class UInstancedStaticMeshComponent;
+
+/** 同一表现类共享的实例化渲染批次 */
+USTRUCT()
+struct FItemDropBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Component = nullptr;
+
+	/** 该批次对应的物品表现类 */
+	UPROPERTY()
+	TSubclassOf<ABaseItemActor> VisualClass;
+
+	/** 实例索引 -> 掉落句柄，与组件中的实例一一对应 */
+	TArray<int32> InstanceToDrop;
+
+	bool bRenderStateDirty = false;
+};
+
+/** 以实例形式存在的掉落物品 */
+USTRUCT()
+struct FItemDrop
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UBaseItem* Item = nullptr;
+
+	FTransform Transform;
+	int32 BatchIndex = INDEX_NONE;
+	int32 InstanceIndex = INDEX_NONE;
+
+	/** 掉落标识，由物品 ID 与位置确定，服务器与客户端对同一次掉落计算出相同的值 */
+	uint32 DropKey = 0;
+};
+
+/**
+ * 物品掉落子系统
+ *
+ * 表现类配置了 InstancedDropMesh 的掉落物品不生成 Actor，而是作为同类共享的
+ * 实例化静态网格体中的一个实例渲染，并登记在空间哈希中。玩家进入提升半径或主动交互时，
+ * 才把该实例提升为完整的 ABaseItemActor。
+ *
+ * 联网时只有服务器提升表现类会复制的掉落，客户端保留实例渲染，
+ * 直到服务器生成的 Actor 复制到达后再移除对应的实例；不复制的表现类在各端各自提升。
+ * 提升生成的 Actor 携带掉落标识（ABaseItemActor::DropKey），客户端按标识精确找到对应的实例。
+ */
+UCLASS()
+class SINGULARISINVENTORY_API UItemDropSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品掉落",
+		meta = (
+			DisplayName = "掉落物品",
+			ToolTip = "在世界中掉落物品。表现类配置了实例化掉落网格体时以实例渲染并返回空，否则直接生成并返回物品表现 Actor"
+		)
+	)
+	ABaseItemActor* DropItem(UBaseItem* Item, FTransform Transform);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品掉落",
+		meta = (
+			DisplayName = "提升半径内的掉落物品",
+			ToolTip = "把指定位置半径内以实例渲染的掉落物品提升为完整的物品表现 Actor，例如玩家发起交互时。客户端只提升表现类不复制的掉落"
+		)
+	)
+	void PromoteDropsInRadius(FVector Location, float Radius, TArray<ABaseItemActor*>& OutActors);
+
+	UFUNCTION(
+		BlueprintCallable,
+		BlueprintPure,
+		Category="物品掉落",
+		meta = (
+			DisplayName = "实例化掉落数量",
+			ToolTip = "当前以实例形式渲染的掉落物品数量"
+		)
+	)
+	int32 GetNumInstancedDrops() const { return SpatialHash.Num(); }
+
+	/** 复制到客户端的物品表现 Actor 开始游戏时调用，移除掉落标识相同的同类本地实例掉落 */
+	void ReleaseReplicatedDrop(const ABaseItemActor* ItemActor);
+
+	/** 计算掉落标识：物品 ID 与按厘米取整的位置，取整抵消位置复制的量化误差，结果不为 0 */
+	static uint32 MakeDropKey(int32 ItemID, const FVector& Location);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** 获取或创建表现类对应的渲染批次，表现类未配置网格体时返回 INDEX_NONE */
+	int32 FindOrAddBatch(TSubclassOf<ABaseItemActor> VisualClass);
+
+	/** 提升半径内的掉落物品，OutActors 为空时不收集生成的 Actor */
+	void PromoteDropsNear(const FVector& Location, float Radius, TArray<ABaseItemActor*>* OutActors);
+
+	/** 把掉落句柄对应的实例提升为 Actor，本端不负责提升该批次时返回 nullptr */
+	ABaseItemActor* PromoteDrop(int32 DropHandle);
+
+	/** 本端是否可以把该批次的掉落提升为 Actor：服务器、单机，或表现类不复制 */
+	bool CanPromoteBatch(const FItemDropBatch& Batch) const;
+
+	/** 移除掉落对应的实例并从空间哈希中移除，批次中最后一个实例移入空出的索引 */
+	void RemoveDropInstance(int32 DropHandle);
+
+	/** 生成完整的物品表现 Actor，DropKey 为 0 表示不是由实例掉落提升而来 */
+	ABaseItemActor* SpawnItemActor(UBaseItem* Item, const FTransform& Transform, uint32 DropKey = 0) const;
+
+	/** 承载所有实例化网格体组件的 Actor */
+	UPROPERTY(Transient)
+	AActor* HostActor = nullptr;
+
+	UPROPERTY(Transient)
+	TArray<FItemDropBatch> Batches;
+
+	/** 掉落句柄（即空间哈希句柄）-> 掉落数据 */
+	UPROPERTY(Transient)
+	TArray<FItemDrop> Drops;
+
+	TMap<TObjectKey<UClass>, int32> ClassToBatch;
+
+	/** 掉落标识 -> 掉落句柄，同一位置的同种物品可能有多个 */
+	TMultiMap<uint32, int32> KeyToDrop;
+
+	FItemSpatialHash SpatialHash;
+};
@@ -0,0 +1,105 @@
+/* =====================================================================
+ * ItemSpatialHash.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 世界物品的均匀网格空间哈希
+ *
+ * 以水平面 (X, Y) 划分网格单元，距离判断使用三维距离。每个条目以整数句柄表示，
+ * 增删改均为 O(1)，半径查询与最近查询只访问查询范围覆盖的网格单元。
+ */
+class SINGULARISINVENTORY_API FItemSpatialHash
+{
+public:
+	explicit FItemSpatialHash(float InCellSize = 500.0f);
+
+	/** 添加条目，返回句柄 */
+	int32 Add(const FVector& Location);
+
+	/** 移除条目，句柄随后可能被复用 */
+	void Remove(int32 Handle);
+
+	/** 更新条目位置，仍在同一网格单元内时只更新坐标 */
+	void Update(int32 Handle, const FVector& Location);
+
+	bool IsValidHandle(const int32 Handle) const
+	{
+		return Entries.IsValidIndex(Handle) && Entries[Handle].IndexInCell != INDEX_NONE;
+	}
+
+	const FVector& GetLocation(const int32 Handle) const
+	{
+		return Entries[Handle].Location;
+	}
+
+	/** 遍历半径内的所有条目，回调参数为 (句柄, 距离平方) */
+	template <typename FunctorType>
+	void ForEachInRadius(const FVector& Center, float Radius, FunctorType&& Functor) const;
+
+	/** 查找最大半径内距离最近的条目，找不到时返回 INDEX_NONE */
+	int32 FindNearest(const FVector& Center, float MaxRadius, float* OutDistanceSquared = nullptr) const;
+
+	/** 有效条目数量 */
+	int32 Num() const { return NumEntries; }
+
+	float GetCellSize() const { return CellSize; }
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FEntry
+	{
+		FVector Location = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+
+		/** 在网格单元数组中的位置，INDEX_NONE 表示该句柄空闲 */
+		int32 IndexInCell = INDEX_NONE;
+	};
+
+	FIntPoint ToCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Location.X * InvCellSize), FMath::FloorToInt32(Location.Y * InvCellSize));
+	}
+
+	void LinkToCell(int32 Handle, const FIntPoint& Cell);
+	void UnlinkFromCell(int32 Handle);
+
+	float CellSize;
+	float InvCellSize;
+	int32 NumEntries = 0;
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeHandles;
+	TMap<FIntPoint, TArray<int32>> Cells;
+};
+
+template <typename FunctorType>
+void FItemSpatialHash::ForEachInRadius(const FVector& Center, const float Radius, FunctorType&& Functor) const
+{
+	const float RadiusSquared = Radius * Radius;
+	const FIntPoint Min = ToCell(Center - FVector(Radius));
+	const FIntPoint Max = ToCell(Center + FVector(Radius));
+
+	for (int32 X = Min.X; X <= Max.X; ++X)
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+			if (!Cell) continue;
+
+			for (const int32 Handle : *Cell)
+			{
+				const float DistanceSquared = FVector::DistSquared(Entries[Handle].Location, Center);
+				if (DistanceSquared <= RadiusSquared)
+					Functor(Handle, DistanceSquared);
+			}
+		}
+}
@@ -0,0 +1,71 @@
+/* =====================================================================
+ * ItemSpatialSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ItemSpatialHash.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemSpatialSubsystem.generated.h"
+
+class ABaseItemActor;
+
+/**
+ * 世界物品空间索引子系统
+ *
+ * ABaseItemActor 在生成与销毁时自动注册到网格空间哈希中，
+ * 拾取检测只需要访问查询位置附近的网格单元，而不必进行通用的重叠或射线检测。
+ */
+UCLASS()
+class SINGULARISINVENTORY_API UItemSpatialSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** 注册世界物品，返回空间句柄 */
+	int32 RegisterItemActor(ABaseItemActor* ItemActor);
+
+	/** 注销世界物品 */
+	void UnregisterItemActor(int32 Handle);
+
+	/** 更新世界物品的位置 */
+	void UpdateItemActor(int32 Handle, const FVector& Location);
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品空间索引",
+		meta = (
+			DisplayName = "查询半径内的物品",
+			ToolTip = "查询指定位置半径内的所有世界物品，结果按距离由近到远排序"
+		)
+	)
+	void QueryItemsInRadius(FVector Location, float Radius, TArray<ABaseItemActor*>& OutItems) const;
+
+	UFUNCTION(
+		BlueprintCallable,
+		Category="物品空间索引",
+		meta = (
+			DisplayName = "查找最近的物品",
+			ToolTip = "查找指定位置最大半径内距离最近的世界物品，找不到时返回空"
+		)
+	)
+	ABaseItemActor* FindNearestItem(FVector Location, float MaxRadius) const;
+
+	/** 已注册的世界物品数量 */
+	int32 Num() const { return SpatialHash.Num(); }
+
+private:
+	FItemSpatialHash SpatialHash;
+
+	/** 空间句柄 -> 世界物品 */
+	TArray<TWeakObjectPtr<ABaseItemActor>> HandleToActor;
+};
@@ -0,0 +1,82 @@
+/* =====================================================================
+ * SInventoryGrid.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InventoryGridStyle.h"
+#include "UObject/GCObject.h"
+#include "Widgets/SCompoundWidget.h"
+
+class SInvalidationPanel;
+class SInventoryGridSlot;
+class SUniformGridPanel;
+class UInventoryManager;
+
+/**
+ * 原生库存槽位网格
+ *
+ * 直接读取库存管理器的槽位绘制，不经过蓝图虚拟机。每个槽位是一个缓存了图标画刷、
+ * 数量文本及其尺寸的叶子控件，槽位内容变化时只使该槽位的绘制失效；
+ * 整个网格放在失效面板中，未变化的槽位复用缓存的绘制结果。
+ *
+ * 画刷不会向 GC 报告其资源对象，网格作为 FGCObject 引用各槽位正在显示的图标
+ * 以及样式副本中画刷与字体引用的资源，避免它们在显示期间被回收。
+ */
+class SINGULARISINVENTORY_API SInventoryGrid : public SCompoundWidget, public FGCObject
+{
+public:
+	SLATE_BEGIN_ARGS(SInventoryGrid)
+		: _Columns(10)
+	{}
+		SLATE_ARGUMENT(TWeakObjectPtr<UInventoryManager>, Inventory)
+		SLATE_ARGUMENT(int32, Columns)
+
+		/** 网格复制一份样式，调用者修改自己的样式后需通过 SetLayout 重新传入 */
+		SLATE_ARGUMENT(FInventoryGridStyle, Style)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SInventoryGrid() override;
+
+	/** 切换显示的库存，并重新建立全部槽位 */
+	void SetInventory(UInventoryManager* InInventory);
+
+	/** 修改列数或样式后重新建立全部槽位 */
+	void SetLayout(int32 InColumns, const FInventoryGridStyle& InStyle);
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~ End FGCObject Interface
+
+private:
+	void BindInventory();
+	void UnbindInventory();
+
+	void RebuildSlots();
+	void RefreshSlot(int32 SlotIndex) const;
+
+	void HandleSlotChanged(UInventoryManager* ChangedInventory, int32 SlotIndex);
+	void HandleSelectChanged(UInventoryManager* ChangedInventory, int32 SelectIndex);
+	void HandleSlotClicked(int32 SlotIndex) const;
+
+	TWeakObjectPtr<UInventoryManager> Inventory;
+	int32 Columns = 10;
+	/** 网格持有的样式副本，与各槽位共享；修改布局时替换为新的副本，已有槽位随之重建 */
+	TSharedRef<FInventoryGridStyle> Style = MakeShared<FInventoryGridStyle>();
+
+	TSharedPtr<SInvalidationPanel> InvalidationPanel;
+	TSharedPtr<SUniformGridPanel> GridPanel;
+	TArray<TSharedPtr<SInventoryGridSlot>> SlotWidgets;
+	int32 SelectedSlot = INDEX_NONE;
+
+	FDelegateHandle SlotChangedHandle;
+	FDelegateHandle SelectChangedHandle;
+};
@@ -9,7 +9,13 @@
 
 #pragma once
 
+#include "HAL/LowLevelMemTracker.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("SingularisInventory"), STATGROUP_SingularisInventory, STATCAT_Advanced);
+
+LLM_DECLARE_TAG_API(SingularisInventory, SINGULARISINVENTORY_API);
 
 class FSingularisInventoryModule final : public IModuleInterface
 {